@@ -0,0 +1,142 @@
+/*
+ * Accuracy of the single precision compensation (no sensor needed).
+ *
+ * Sweeps the raw ADC range and compares BME::compensateFloat() with the compensation path
+ * of the library build:
+ *   - default:                double  (BME280_DOUBLE_ENABLE)
+ *   - -DBME280_32BIT_ENABLE:  int32
+ *   - -DBME280_64BIT_ENABLE:  int64
+ * Temperature, pressure and humidity are swept independently: for every raw temperature in the operating
+ * range (-40...85 °C) the raw pressure and the raw humidity are swept over their full range. Pressure and
+ * humidity outside of their range (300...1100 hPa, 0...100 %) are skipped on their own, there both paths
+ * return the limits.
+ * The limits include the resolution of the integer paths (0.01 °C, 1 Pa resp. 0.01 Pa, 1/1024 %),
+ * the int32 pressure compensation has an error of a few Pa. The host build returns 1 if a limit fails.
+ */
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+
+#if defined (BME280_DOUBLE_ENABLE)
+const char *path_name = "double";
+const float limit_temperature {0.001F};
+const float limit_pressure {0.1F};
+const float limit_humidity {0.001F};
+#elif defined (BME280_32BIT_ENABLE)
+const char *path_name = "int32";
+const float limit_temperature {0.02F};
+const float limit_pressure {8.0F};
+const float limit_humidity {0.01F};
+#else
+const char *path_name = "int64";
+const float limit_temperature {0.02F};
+const float limit_pressure {1.0F};
+const float limit_humidity {0.01F};
+#endif
+
+// calibration data of the Bosch datasheet example
+struct bme280_calib_data calib {27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000, 75, 362, 0, 313, 50, 30, 0};
+
+// number of steps over the 20 bit range of temperature, most of it is outside of the operating range
+const uint32_t steps_t {256};
+
+// number of steps over the 20 bit range of pressure and the 16 bit range of humidity
+const uint32_t steps {64};
+
+// number of quantities above their limit
+uint8_t failures {0};
+
+// compensated values of the library path in °C, Pa and %
+void reference(const struct bme280_uncomp_data &raw, float &temperature, float &pressure, float &humidity) {
+  struct bme280_data data;
+  bme280_compensate_data(BME280_ALL, &raw, &data, &calib);
+#if defined (BME280_DOUBLE_ENABLE)
+  temperature = data.temperature;
+  pressure = data.pressure;
+  humidity = data.humidity;
+#elif defined (BME280_32BIT_ENABLE)
+  temperature = data.temperature / 100.0F;
+  pressure = data.pressure;
+  humidity = data.humidity / 1024.0F;
+#else
+  temperature = data.temperature / 100.0F;
+  pressure = data.pressure / 100.0F;
+  humidity = data.humidity / 1024.0F;
+#endif
+}
+
+void updateError(float &max_error, float value, float reference) {
+  float error = fabs(value - reference);
+  if (error > max_error) {
+    max_error = error;
+  }
+}
+
+void printResult(const char *quantity, uint32_t samples, float max_error, float limit) {
+  // machine readable: path;quantity;samples;max_error;limit;result
+  bool pass = samples > 0 && max_error <= limit;
+  if (!pass) {
+    ++failures;
+  }
+  Serial.print(path_name);
+  Serial.print(';');
+  Serial.print(quantity);
+  Serial.print(';');
+  Serial.print(samples);
+  Serial.print(';');
+  Serial.print(max_error, 5);
+  Serial.print(';');
+  Serial.print(limit, 5);
+  Serial.print(';');
+  Serial.println(pass ? "pass" : "fail");
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    yield();
+  }
+  float error_temperature {0.0F}, error_pressure {0.0F}, error_humidity {0.0F};
+  uint32_t samples_temperature {0}, samples_pressure {0}, samples_humidity {0};
+  for (uint32_t t = 0; t < steps_t; ++t) {
+    uint32_t adc_t = (t << 20) / steps_t;
+    float temperature, pressure, humidity;
+    BME::FloatData data;
+    struct bme280_uncomp_data raw {0, adc_t, 0};
+    reference(raw, temperature, pressure, humidity);
+    if (temperature <= -40.0F || temperature >= 85.0F) {
+      // pressure and humidity are specified in the temperature range only, outside the int32 pressure is not valid
+      continue;
+    }
+    BME::compensateFloat(raw, calib, data, BME280_TEMP);
+    updateError(error_temperature, data.temperature, temperature);
+    ++samples_temperature;
+    for (uint32_t p = 0; p < steps; ++p) {
+      // pressure sweep at the temperature of the step t
+      raw = bme280_uncomp_data {(p << 20) / steps, adc_t, 0};
+      reference(raw, temperature, pressure, humidity);
+      BME::compensateFloat(raw, calib, data, BME280_PRESS);
+      if (pressure > 30000.0F && pressure < 110000.0F) {
+        updateError(error_pressure, data.pressure, pressure);
+        ++samples_pressure;
+      }
+    }
+    for (uint32_t h = 0; h < steps; ++h) {
+      // humidity sweep at the temperature of the step t
+      raw = bme280_uncomp_data {0, adc_t, (h << 16) / steps};
+      reference(raw, temperature, pressure, humidity);
+      BME::compensateFloat(raw, calib, data, BME280_HUM);
+      if (humidity > 0.0F && humidity < 100.0F) {
+        updateError(error_humidity, data.humidity, humidity);
+        ++samples_humidity;
+      }
+    }
+    yield();
+  }
+  Serial.println("\npath;quantity;samples;max_error;limit;result");
+  printResult("temperature", samples_temperature, error_temperature, limit_temperature);
+  printResult("pressure", samples_pressure, error_pressure, limit_pressure);
+  printResult("humidity", samples_humidity, error_humidity, limit_humidity);
+}
+
+void loop() {
+}
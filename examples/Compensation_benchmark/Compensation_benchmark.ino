@@ -0,0 +1,100 @@
+/*
+ * Benchmark of the Bosch compensation functions (no sensor needed).
+ *
+ * The compensation path is selected at build time for the whole library:
+ *   - default:                double  (BME280_DOUBLE_ENABLE)
+ *   - -DBME280_32BIT_ENABLE:  int32
+ *   - -DBME280_64BIT_ENABLE:  int64
+ *   - -DBME280_FLOAT_ENABLE:  float   (the wrapper uses the single precision kernels, the Bosch driver is built with double)
+ * Build the sketch once per path and compare the printed results.
+ * The Bosch functions are printed with the path of the driver build, the single precision kernels
+ * (BME::compensateFloat) are measured in every build as path "float".
+ */
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+
+// path of the library and of the Bosch driver, the float build defines BME280_DOUBLE_ENABLE as well
+#if defined (BME280_FLOAT_ENABLE)
+const char *path_name = "float";
+const char *driver_name = "double";
+#elif defined (BME280_DOUBLE_ENABLE)
+const char *path_name = "double";
+const char *driver_name = "double";
+#elif defined (BME280_32BIT_ENABLE)
+const char *path_name = "int32";
+const char *driver_name = "int32";
+#else
+const char *path_name = "int64";
+const char *driver_name = "int64";
+#endif
+
+// calibration data of the Bosch datasheet example
+struct bme280_calib_data calib {27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000, 75, 362, 0, 313, 50, 30, 0};
+
+// raw ADC values around room conditions
+const struct bme280_uncomp_data raw[] {
+  {415148, 519888, 30000},
+  {410000, 530000, 28000},
+  {420000, 500000, 32000},
+  {400000, 540000, 26000}
+};
+
+const uint32_t iterations {1000};
+
+void printResult(const char *path, const char *name, uint32_t duration) {
+  float us_per_call = (float) duration / iterations;
+
+  // machine readable: path;function;iterations;us_per_call;cycles_per_call
+  Serial.print(path);
+  Serial.print(';');
+  Serial.print(name);
+  Serial.print(';');
+  Serial.print(iterations);
+  Serial.print(';');
+  Serial.print(us_per_call, 3);
+  Serial.print(';');
+  Serial.println((uint32_t) (us_per_call * (F_CPU / 1000000UL)));
+}
+
+void benchmark(const char *name, uint8_t sensor_comp) {
+  struct bme280_data data;
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    bme280_compensate_data(sensor_comp, &raw[i & 0x03], &data, &calib);
+    // compiler barrier: the results count as used, without adding arithmetic to the loop
+    asm volatile("" : : "r"(&data) : "memory");
+  }
+  printResult(driver_name, name, micros() - start);
+}
+
+void benchmarkFloat(const char *name, uint8_t sensor_comp) {
+  BME::FloatData data;
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    BME::compensateFloat(raw[i & 0x03], calib, data, sensor_comp);
+    asm volatile("" : : "r"(&data) : "memory");
+  }
+  printResult("float", name, micros() - start);
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    yield();
+  }
+  Serial.print("\nlibrary path: ");
+  Serial.println(path_name);
+  Serial.println("path;function;iterations;us_per_call;cycles_per_call");
+  // temperature is always compensated, pressure and humidity need t_fine
+  benchmark("temperature", BME280_TEMP);
+  benchmark("temperature+pressure", BME280_PRESS);
+  benchmark("temperature+humidity", BME280_HUM);
+  benchmark("all", BME280_ALL);
+  benchmarkFloat("temperature", BME280_TEMP);
+  benchmarkFloat("temperature+pressure", BME280_PRESS);
+  benchmarkFloat("temperature+humidity", BME280_HUM);
+  benchmarkFloat("all", BME280_ALL);
+}
+
+void loop() {
+}
@@ -0,0 +1,43 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include <Bosch_BME280_Arduino.h>
+
+// sensor state in RTC memory, kept during deep sleep
+RTC_DATA_ATTR BME::ResumeState bme_state;
+
+BME::Bosch_BME280 bme{BME280_I2C_ADDR_PRIM, 249.67F, true};
+
+const uint64_t sleep_time_us {60ULL * 1000000ULL};
+
+void setup() {
+  uint32_t start = micros();
+  Wire.setPins(SDA, SCL);
+  Wire.begin();
+
+  // first boot: full init, after deep sleep: chip id check, settings and first sample in one conversion time
+  int8_t result = bme.resume(bme_state);
+  uint32_t duration = micros() - start;
+
+  Serial.begin(115200);
+  if (result != BME280_OK) {
+    Serial.println("\n\t>>> ERROR: Resume of Bosch BME280 Sensor failed! <<<");
+  }
+  else {
+    // after the first boot resume() has taken a sample already
+    if (bme.isReady() == false) {
+      bme.measure();
+    }
+    Serial.printf("\n\tWake to sample:\t%u us\n", duration);
+    Serial.printf("\tTemperature:\t%.2f\n", bme.getTemperature());
+    Serial.printf("\tHumidity:\t%.2f\n", bme.getHumidity());
+    Serial.printf("\tPressure at NN:\t%.2f\n", bme.getSealevelForAltitude());
+  }
+  Serial.flush();
+
+  bme.saveState(bme_state);
+  esp_sleep_enable_timer_wakeup(sleep_time_us);
+  esp_deep_sleep_start();
+}
+
+void loop() {
+}
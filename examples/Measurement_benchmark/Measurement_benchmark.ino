@@ -0,0 +1,91 @@
+/*
+ * Benchmark of the full measurement cycle against the simulated sensor (no sensor needed).
+ *
+ * Measures the latency of measure() in forced and normal mode and the bus traffic per sample,
+ * also with skipped pressure / humidity (shorter conversion and burst read, see setChannels()).
+ * The compensation path is selected at build time for the whole library, see Compensation_benchmark.
+ * With -DBME280_STATS_ENABLE the time on the bus and in delays per sample is printed as well.
+ */
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+#include <Bosch_BME280_Simulator.h>
+
+// the float build defines BME280_DOUBLE_ENABLE as well
+#if defined (BME280_FLOAT_ENABLE)
+const char *path_name = "float";
+#elif defined (BME280_DOUBLE_ENABLE)
+const char *path_name = "double";
+#elif defined (BME280_32BIT_ENABLE)
+const char *path_name = "int32";
+#else
+const char *path_name = "int64";
+#endif
+
+const uint32_t samples {100};
+
+void benchmark(const char *name, bool forced_mode, uint8_t channels = BME280_ALL) {
+  BME::SimulatedBME280 sim;
+  BME::Bosch_BME280 bme{sim, 249.67F, forced_mode};
+  bme.setChannels(channels);
+  if (bme.begin() != BME280_OK) {
+    Serial.println("\n\t>>> ERROR: Init of simulated Bosch BME280 Sensor failed! <<<");
+    return;
+  }
+  sim.resetCounters();
+#ifdef BME280_STATS_ENABLE
+  bme.resetStats();
+#endif
+
+  uint32_t start = micros();
+  for (uint32_t i = 0; i < samples; ++i) {
+    bme.measure();
+  }
+  uint32_t duration = micros() - start;
+
+  // machine readable: path;mode;samples;us_per_sample;reads_per_sample;writes_per_sample;bytes_per_sample[;bus_us_per_sample;delay_us_per_sample]
+  const BME::SimulatorCounters &counters = sim.getCounters();
+  Serial.print(path_name);
+  Serial.print(';');
+  Serial.print(name);
+  Serial.print(';');
+  Serial.print(samples);
+  Serial.print(';');
+  Serial.print((float) duration / samples, 1);
+  Serial.print(';');
+  Serial.print((float) counters.reads / samples, 2);
+  Serial.print(';');
+  Serial.print((float) counters.writes / samples, 2);
+  Serial.print(';');
+#ifdef BME280_STATS_ENABLE
+  Serial.print((float) (counters.read_bytes + counters.write_bytes) / samples, 2);
+  BME::ApiStats stats = bme.getStats().total();
+  Serial.print(';');
+  Serial.print((float) stats.bus_us / samples, 1);
+  Serial.print(';');
+  Serial.println((float) stats.delay_us / samples, 1);
+#else
+  Serial.println((float) (counters.read_bytes + counters.write_bytes) / samples, 2);
+#endif
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) {
+    yield();
+  }
+#ifdef BME280_STATS_ENABLE
+  Serial.println("\npath;mode;samples;us_per_sample;reads_per_sample;writes_per_sample;bytes_per_sample;bus_us_per_sample;delay_us_per_sample");
+#else
+  Serial.println("\npath;mode;samples;us_per_sample;reads_per_sample;writes_per_sample;bytes_per_sample");
+#endif
+  // forced mode: trigger, wait for the conversion, read
+  benchmark("forced", true);
+  benchmark("forced_t_h", true, BME280_TEMP | BME280_HUM);
+  benchmark("forced_t_p", true, BME280_TEMP | BME280_PRESS);
+  benchmark("forced_t", true, BME280_TEMP);
+  // normal mode: read the last conversion of the continuously measuring sensor
+  benchmark("normal", false);
+}
+
+void loop() {
+}
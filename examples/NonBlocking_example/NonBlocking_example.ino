@@ -0,0 +1,54 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include <Bosch_BME280_Arduino.h>
+
+// global instance
+BME::Bosch_BME280 bme{BME280_I2C_ADDR_PRIM, 249.67F, true};
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial) {
+      yield();
+    }
+
+   // SDA, SCL needed for ESPs
+#if defined (ESP8266)
+  Wire.begin(SDA, SCL);
+#elif defined (ESP32)
+  Wire.setPins(SDA, SCL);
+  Wire.begin();
+#else
+  Wire.begin();
+#endif
+
+   // init Bosch BME 280 Sensor
+   if (bme.begin() != 0) {
+      Serial.println("\n\t>>> ERROR: Init of Bosch BME280 Sensor failed! <<<");
+   }
+}
+
+void loop() {
+    static unsigned long tic {millis()};
+    unsigned long ms = millis();
+
+    // trigger a conversion every 2 s, loop() is not blocked while the sensor converts
+    if (ms - tic >= 2000) {
+      tic = ms;
+      bme.startMeasurement();
+    }
+
+    // poll() reads the data registers as soon as the conversion time has elapsed
+    if (bme.isMeasuring()) {
+      bme.poll();
+      if (bme.isReady()) {
+        Serial.print("\n\tTemperature:\t");
+        Serial.println(bme.getTemperature());
+        Serial.print("\tHumidity:\t");
+        Serial.println(bme.getHumidity());
+        Serial.print("\tPressure at NN:\t");
+        Serial.println(bme.getSealevelForAltitude());
+      }
+    }
+
+    // do other work here
+}
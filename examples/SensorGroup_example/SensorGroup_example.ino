@@ -0,0 +1,63 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include <Bosch_BME280_Arduino.h>
+#include <Bosch_BME280_Group.h>
+
+// two sensors on the first I²C-Bus
+BME::Bosch_BME280 bme_1{BME280_I2C_ADDR_PRIM, 249.67F, true};
+BME::Bosch_BME280 bme_2{BME280_I2C_ADDR_SEC, 249.67F, true};
+#if defined (ESP32)
+// two sensors on the second I²C-Bus
+BME::Bosch_BME280 bme_3{BME280_I2C_ADDR_PRIM, 249.67F, true, Wire1};
+BME::Bosch_BME280 bme_4{BME280_I2C_ADDR_SEC, 249.67F, true, Wire1};
+#endif
+
+BME::SensorGroup<4> sensors;
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial) {
+      yield();
+    }
+
+#if defined (ESP8266)
+  Wire.begin(SDA, SCL);
+#elif defined (ESP32)
+  Wire.begin();
+  // set the pins of the second bus for your board
+  Wire1.begin();
+#else
+  Wire.begin();
+#endif
+
+  sensors.add(bme_1);
+  sensors.add(bme_2);
+#if defined (ESP32)
+  sensors.add(bme_3);
+  sensors.add(bme_4);
+#endif
+
+   if (sensors.begin() != 0) {
+      Serial.println("\n\t>>> ERROR: Init of Bosch BME280 Sensors failed! <<<");
+   }
+}
+
+void loop() {
+    static unsigned long tic {millis()};
+    unsigned long ms = millis();
+    if (ms - tic >= 2000) {
+      tic = ms;
+      // all conversions run in parallel, the group waits once for the longest one
+      sensors.measure();
+      for (uint8_t i = 0; i < sensors.size(); ++i) {
+        Serial.print("\n\tSensor ");
+        Serial.println(i);
+        Serial.print("\tTemperature:\t");
+        Serial.println(sensors[i].getTemperature());
+        Serial.print("\tHumidity:\t");
+        Serial.println(sensors[i].getHumidity());
+        Serial.print("\tPressure at NN:\t");
+        Serial.println(sensors[i].getSealevelForAltitude());
+      }
+    }
+}
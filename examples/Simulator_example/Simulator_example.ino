@@ -0,0 +1,57 @@
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+#include <Bosch_BME280_Simulator.h>
+
+// simulated sensor, no hardware needed
+BME::SimulatedBME280 sim;
+BME::Bosch_BME280 bme{sim, 249.67F, true};
+
+// slow temperature ramp and a daily pressure swing
+BME::Environment environment(uint32_t time_ms) {
+  float hours = time_ms / 3600000.0F;
+  return BME::Environment{20.0F + 0.01F * (time_ms / 1000), 101325.0F + 200.0F * (float) sin(hours * 2.0F * (float) PI / 24.0F), 50.0F};
+}
+
+void setup() {
+    Serial.begin(115200);
+    while (!Serial) {
+      yield();
+    }
+
+   sim.setEnvironmentModel(environment);
+
+   // init simulated Bosch BME 280 Sensor
+   if (bme.begin() != 0) {
+      Serial.println("\n\t>>> ERROR: Init of simulated Bosch BME280 Sensor failed! <<<");
+   }
+   sim.resetCounters();
+}
+
+void loop() {
+    static unsigned long tic {millis()};
+    unsigned long ms = millis();
+    if (ms - tic >= 2000) {
+      tic = ms;
+      bme.measure();
+      Serial.print("\n\tTemperature:\t");
+      Serial.println(bme.getTemperature());
+      Serial.print("\tHumidity:\t");
+      Serial.println(bme.getHumidity());
+      Serial.print("\tPressure:\t");
+      Serial.println(bme.getPressure());
+
+      const BME::SimulatorCounters &counters = sim.getCounters();
+      Serial.print("\tBus reads:\t");
+      Serial.print(counters.reads);
+      Serial.print(" (");
+      Serial.print(counters.read_bytes);
+      Serial.println(" bytes)");
+      Serial.print("\tBus writes:\t");
+      Serial.print(counters.writes);
+      Serial.print(" (");
+      Serial.print(counters.write_bytes);
+      Serial.println(" bytes)");
+      Serial.print("\tConversions:\t");
+      Serial.println(counters.conversions);
+    }
+}
@@ -6,12 +6,65 @@
  * @brief   Bosch BME280 Arduino Wrapper Class based on BME280 Bosch driver v3.5.1
  */
 #include <Bosch_BME280_Arduino.h>
-#include <Wire.h>
 
-BME::Bosch_BME280::Bosch_BME280(uint8_t addr, float altitude, bool forced_mode) :
+namespace {
+  // marker of a saved state, changed with the layout of ResumeState
+  const uint16_t RESUME_MAGIC {0xB281};
+}
+
+BME::Bosch_BME280::Bosch_BME280(uint8_t addr, float altitude, bool forced_mode, TwoWire &wire) :
+   Bosch_BME280(altitude, forced_mode, nullptr, I2CTransport::intf,
+                &busRead<I2CTransport>, &busWrite<I2CTransport>, &busBegin<I2CTransport>)
+{
+  _i2c = I2CTransport(wire, addr);
+}
+
+BME::Bosch_BME280::Bosch_BME280(float altitude, bool forced_mode, void *transport, enum bme280_intf intf,
+                                bme280_read_fptr_t bus_read, bme280_write_fptr_t bus_write, int8_t (*bus_begin)(void *transport)) :
+   _dev {},
+#ifdef BME280_FLOAT_ENABLE
+   _compensation {{}, BME280_ALL, 0},
+#else
+   _compensation {{}, BME280_ALL},
+#endif
+   _raw_sequence {0},
+   _raw_data {0, 0, 0},
+   _settings {PRESET_WEATHER_MONITORING.osr_p, PRESET_WEATHER_MONITORING.osr_t, PRESET_WEATHER_MONITORING.osr_h,
+              PRESET_WEATHER_MONITORING.filter, PRESET_WEATHER_MONITORING.standby},
+   _requested (PRESET_WEATHER_MONITORING),
+   _channels {BME280_ALL},
+   _period {0},
    _altitude {altitude},
+   _sealevel_factor {seaLevelFactor(altitude)},
    _sensor_status {BME280_OK},
-   _addr {addr}
+   _transport {transport},
+   _intf {intf},
+   _bus_read {bus_read},
+   _bus_write {bus_write},
+   _bus_begin {bus_begin},
+   _meas_start {0},
+   _measuring {false},
+   _data_ready {false},
+   _reg_ctrl_meas {0},
+   _reg_ctrl_hum {0},
+   _reg_config {0},
+   _reg_cache_valid {false},
+   _sample_buffer {nullptr},
+   _raw_buffer {nullptr},
+   _raw_capture {false},
+   _sample_time {0},
+   _sample_bytes {0},
+   _status_polling {false},
+   _poll_interval {500},
+   _poll_timeout {0},
+   _status_poll_time {0},
+   _conversion_time {0},
+   _cycle_period {0},
+   _cycle_sync {0},
+   _cycle_synced {false},
+   _cycle_unread {false},
+   _scheduler_stats {0, 0, 0, 0},
+   _calib_loaded {false}
 {
   // set internal _mode
   if (forced_mode) {
@@ -20,27 +73,143 @@ BME::Bosch_BME280::Bosch_BME280(uint8_t addr, float altitude, bool forced_mode)
   else {
     _mode = BME280_POWERMODE_NORMAL;
   }
+#ifdef BME280_STATS_ENABLE
+  _stats_api = STATS_OTHER;
+  resetStats();
+#endif
+#ifdef ESP32
+  _timer = nullptr;
+  _timer_running = false;
+  _timer_busy = false;
+  portMUX_INITIALIZE(&_mux);
+#endif
+}
+
+#ifdef ESP32
+BME::Bosch_BME280::~Bosch_BME280() {
+  if (_timer != nullptr) {
+    stopScheduler();
+    esp_timer_delete(_timer);
+  }
 }
+#endif
 
 int8_t BME::Bosch_BME280::begin() {
-  _dev.intf_ptr = &_addr;
-  
-  // I2C init START
-  _dev.intf = BME280_I2C_INTF;
-  _dev.read = &BME::Bosch_BME280::I2CRead;
-  _dev.write = &BME::Bosch_BME280::I2CWrite;
-  _dev.delay_us = &BME::Bosch_BME280::delay_us;
+  StatsScope stats_scope {this, STATS_BEGIN};
+  _sensor_status = beginBus();
+  if (_sensor_status != BME280_OK) {
+    return _sensor_status;
+  }
 
-  // Init of sensor
-  _sensor_status = bme280_init(&_dev);
-  bme280_print_error_codes("bme280_init", _sensor_status);
-  // if normal mode set settings for normal mode
-  setSensorSettings();
-  delay(100);
+  // Init of sensor, after the soft reset the configuration registers are 0 (sleep mode)
+  _sensor_status = initSensor();
+  _reg_ctrl_hum = 0;
+  _reg_ctrl_meas = 0;
+  _reg_config = 0;
+  _reg_cache_valid = (_sensor_status == BME280_OK);
+  if (_sensor_status != BME280_OK) {
+    return _sensor_status;
+  }
+  _sensor_status = setSensorSettings();
+  if (_sensor_status == BME280_OK && _mode == BME280_POWERMODE_NORMAL) {
+    // the data registers are valid after the first conversion
+    _dev.delay_us(_period, _dev.intf_ptr);
+  }
   return _sensor_status;
 }
 
+int8_t BME::Bosch_BME280::resume(const ResumeState &state) {
+  if (state.magic != RESUME_MAGIC) {
+    // no saved state (e.g. first boot)
+    return begin();
+  }
+  StatsScope stats_scope {this, STATS_BEGIN};
+  _sensor_status = beginBus();
+  if (_sensor_status != BME280_OK) {
+    return _sensor_status;
+  }
+
+  // the sensor has to be present, the calibration data are not read again
+  uint8_t chip_id;
+  _sensor_status = bme280_get_regs(BME280_REG_CHIP_ID, &chip_id, 1, &_dev);
+  recordError(ERROR_RESUME, _sensor_status);
+  if (_sensor_status == BME280_OK && chip_id != BME280_CHIP_ID) {
+    _sensor_status = BME280_E_DEV_NOT_FOUND;
+    recordError(ERROR_RESUME, _sensor_status);
+  }
+  if (_sensor_status != BME280_OK) {
+    return _sensor_status;
+  }
+  _dev.chip_id = chip_id;
+  _dev.calib_data = state.calib_data;
+  _settings = state.settings;
+  _requested = state.requested;
+  _channels = state.channels;
+
+  // the registers may be lost (power cycle), so the first write contains all registers
+  _reg_cache_valid = false;
+  if (_mode == BME280_POWERMODE_FORCED) {
+    // first sample right away: settings and trigger in one write, wait for the conversion, read
+    bme280_cal_meas_delay(&_period, &_settings);
+    _sensor_status = measure_forced_mode();
+  }
+  else {
+    _sensor_status = applySettings(BME280_POWERMODE_NORMAL);
+  }
+  return _sensor_status;
+}
+
+void BME::Bosch_BME280::saveState(ResumeState &state) const {
+  // only a successful begin() or resume() leaves a valid state
+  state.magic = (_dev.chip_id == BME280_CHIP_ID) ? RESUME_MAGIC : 0;
+  state.settings = _settings;
+  state.requested = _requested;
+  state.channels = _channels;
+  state.calib_data = _dev.calib_data;
+}
+
+void BME::Bosch_BME280::setCalibData(const struct bme280_calib_data &calib) {
+  _dev.calib_data = calib;
+  _calib_loaded = true;
+}
+
+int8_t BME::Bosch_BME280::initSensor() {
+  if (!_calib_loaded) {
+    int8_t result = bme280_init(&_dev);
+    recordError(ERROR_BEGIN, result);
+    return result;
+  }
+  // same as bme280_init() without reading the calibration data
+  uint8_t chip_id;
+  int8_t result = bme280_get_regs(BME280_REG_CHIP_ID, &chip_id, 1, &_dev);
+  if (result == BME280_OK && chip_id != BME280_CHIP_ID) {
+    result = BME280_E_DEV_NOT_FOUND;
+  }
+  if (result == BME280_OK) {
+    _dev.chip_id = chip_id;
+    result = bme280_soft_reset(&_dev);
+  }
+  recordError(ERROR_BEGIN, result);
+  return result;
+}
+
+int8_t BME::Bosch_BME280::beginBus() {
+  // the address constructor uses the internal I2C transport
+  if (_transport == nullptr) {
+    _transport = &_i2c;
+  }
+  _dev.intf_ptr = this;
+  
+  // bus init START
+  _dev.intf = _intf;
+  _dev.read = _bus_read;
+  _dev.write = _bus_write;
+  _dev.delay_us = &BME::Bosch_BME280::delay_us;
+  return _bus_begin(_transport);
+}
+
 int8_t BME::Bosch_BME280::measure() {
+  StatsScope stats_scope {this, STATS_MEASURE};
   int8_t result;
   if (_mode == BME280_POWERMODE_FORCED) {
     result = measure_forced_mode();
@@ -55,144 +224,586 @@ void BME::Bosch_BME280::setSensorStatus(int8_t sensor_status) {
   _sensor_status = sensor_status;
 }
 
+#ifdef BME280_STATS_ENABLE
+void BME::Bosch_BME280::resetStats() {
+  memset(&_stats, 0, sizeof(_stats));
+}
+#endif
+
+int8_t BME::Bosch_BME280::startMeasurement() {
+  StatsScope stats_scope {this, STATS_START_MEASUREMENT};
+  int8_t result {BME280_OK};
+  _data_ready = false;
+  if (_mode == BME280_POWERMODE_FORCED) {
+    result = triggerForcedMode();
+  }
+  _meas_start = micros();
+  _status_poll_time = _meas_start;
+  _measuring = (result == BME280_OK);
+  return result;
+}
+
+int8_t BME::Bosch_BME280::poll() {
+  StatsScope stats_scope {this, STATS_POLL};
+  if (!_measuring) {
+    return BME280_OK;
+  }
+  // in forced mode the data registers are valid after the conversion time
+  uint32_t now = micros();
+  if (_mode == BME280_POWERMODE_FORCED && (uint32_t)(now - _meas_start) < _period) {
+    // the conversion may finish earlier, check the status register once per interval
+    if (!_status_polling || (uint32_t)(now - _status_poll_time) < _poll_interval) {
+      return BME280_OK;
+    }
+    _status_poll_time = now;
+    bool measuring;
+    int8_t result = readMeasuringStatus(measuring);
+    if (result != BME280_OK || measuring) {
+      return result;
+    }
+    _conversion_time = now - _meas_start;
+  }
+  return finishMeasurement();
+}
+
 int8_t BME::Bosch_BME280::measure_normal_mode() {
-	int8_t result = bme280_get_sensor_data(BME280_ALL, &_bme280_data, &_dev);
-  bme280_print_error_codes("bme280_get_sensor_data", result);
+  _data_ready = false;
+  int8_t result = finishMeasurement();
+  if (result == BME280_OK && _cycle_synced) {
+    // the read is not aligned to the conversion cycle: flag stale data and skipped conversions
+    uint32_t conversions = advanceCycle(micros());
+    if (conversions == 0) {
+      ++_scheduler_stats.duplicates;
+    }
+    else {
+      ++_scheduler_stats.samples;
+      _scheduler_stats.missed += conversions - 1;
+    }
+  }
   return result;
 }
 
-int8_t BME::Bosch_BME280::measure_forced_mode() {
+int8_t BME::Bosch_BME280::synchronize() {
+  if (_mode != BME280_POWERMODE_NORMAL) {
+    return E_INVALID_MODE;
+  }
+  // wait for the falling edge of the measuring bit = end of a conversion
+  uint32_t start = micros();
+  uint32_t timeout = 2 * _cycle_period;
+  bool was_measuring {false};
+  do {
+    bool measuring;
+    int8_t result = readMeasuringStatus(measuring);
+    if (result != BME280_OK) {
+      return result;
+    }
+    if (was_measuring && !measuring) {
+      _cycle_sync = micros();
+      _cycle_synced = true;
+      _cycle_unread = true;
+      return BME280_OK;
+    }
+    was_measuring = measuring;
+    _dev.delay_us(_poll_interval, _dev.intf_ptr);
+  } while ((uint32_t)(micros() - start) < timeout);
+  _cycle_synced = false;
+  recordError(ERROR_SYNCHRONIZE, E_MEAS_TIMEOUT);
+  return E_MEAS_TIMEOUT;
+}
+
+int8_t BME::Bosch_BME280::service() {
+  StatsScope stats_scope {this, STATS_SERVICE};
   int8_t result {BME280_OK};
-  // Calculate the minimum delay in ms required between consecutive measurement based upon the sensor enabled
-  // and the oversampling configuration.
-  result = bme280_cal_meas_delay(&_period, &_settings);
-  bme280_print_error_codes("bme280_cal_meas_delay", result);
-  //Serial.printf("\nCalculated measurement delay: %6d µs\n\n", _period);
-  result = bme280_set_sensor_mode(BME280_POWERMODE_FORCED, &_dev);
-  bme280_print_error_codes("bme280_set_sensor_mode", result);
-  // wait request_delay in µs to complete the measurement
-  _dev.delay_us(_period, _dev.intf_ptr);
-	result = bme280_get_sensor_data(BME280_ALL, &_bme280_data, &_dev);
-  bme280_print_error_codes("bme280_get_sensor_data", result);
+  if (!_cycle_synced) {
+    // read the conversion which has just ended
+    result = synchronize();
+    if (result != BME280_OK) {
+      return result;
+    }
+    _cycle_unread = false;
+  }
+  else {
+    // the next read is due in the standby time after the next conversion, after synchronize() at once
+    uint32_t now = micros();
+    if (!_cycle_unread && (uint32_t)(now - _cycle_sync) < _cycle_period + readOffset()) {
+      return BME280_OK;
+    }
+    _scheduler_stats.missed += advanceCycle(now) - 1;
+  }
+
+  // the status register is read in the same burst to check the phase
+  uint8_t status;
+  uint32_t read_start = micros();
+  _data_ready = false;
+  result = finishMeasurement(&status);
+  if (result != BME280_OK) {
+    return result;
+  }
+  ++_scheduler_stats.samples;
+  if (status & BME280_STATUS_MEAS_DONE) {
+    // read during a conversion (e.g. the caller is late): the conversion which was read ended less than
+    // one period before the read and before the standby time of the running conversion. If the phase is
+    // outside of this window the schedule drifted, it is moved to the nearest edge, so the read conversion
+    // keeps its place and the next missed count is not shortened by a guessed phase
+    uint32_t earliest = read_start - _cycle_period + 1;
+    uint32_t latest = micros() - standbyTime(_settings.standby_time);
+    if ((int32_t)(_cycle_sync - earliest) < 0) {
+      _cycle_sync = earliest;
+      ++_scheduler_stats.resyncs;
+    }
+    else if ((int32_t)(_cycle_sync - latest) > 0) {
+      _cycle_sync = latest;
+      ++_scheduler_stats.resyncs;
+    }
+  }
   return result;
 }
 
-int8_t BME::Bosch_BME280::setSensorSettings() {
-  int8_t result{BME280_OK};
+uint32_t BME::Bosch_BME280::advanceCycle(uint32_t now) {
+  uint32_t conversions = (uint32_t)(now - _cycle_sync) / _cycle_period;
+  _cycle_sync += conversions * _cycle_period;
+  if (_cycle_unread) {
+    // the conversion found by synchronize() is read now or was missed
+    ++conversions;
+    _cycle_unread = false;
+  }
+  return conversions;
+}
 
-  // first get all sensor settings
-  result = bme280_get_sensor_settings(&_settings, &_dev);
-  bme280_print_error_codes("bme280_get_sensor_settings", result);
+#ifdef ESP32
+int8_t BME::Bosch_BME280::startScheduler() {
+  if (_mode != BME280_POWERMODE_NORMAL) {
+    return E_INVALID_MODE;
+  }
+  if (_timer == nullptr) {
+    esp_timer_create_args_t args {};
+    args.callback = &BME::Bosch_BME280::schedulerCallback;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "bme280";
+    if (esp_timer_create(&args, &_timer) != ESP_OK) {
+      _timer = nullptr;
+      return BME280_E_NULL_PTR;
+    }
+  }
+  stopScheduler();
+  // the synchronization blocks, so it runs here in the context of the caller and never in the timer task
+  _cycle_synced = false;
+  int8_t result = service();
+  if (result != BME280_OK) {
+    return result;
+  }
+  _timer_running = true;
+  armScheduler();
+  return BME280_OK;
+}
 
-  // Recommended settings of operation: => weather monitoring
-  _settings.osr_p = BME280_OVERSAMPLING_1X;
-  _settings.osr_t = BME280_OVERSAMPLING_1X;
-  _settings.osr_h = BME280_OVERSAMPLING_1X;
-  _settings.filter = BME280_FILTER_COEFF_OFF;
+void BME::Bosch_BME280::stopScheduler() {
+  {
+    BME280_CRITICAL_SECTION(_mux);
+    _timer_running = false;
+  }
+  // a running callback finishes its read and does not rearm the timer
+  while (_timer_busy) {
+    delay(1);
+  }
+  if (_timer != nullptr) {
+    esp_timer_stop(_timer);
+  }
+}
 
-  if (_mode == BME280_POWERMODE_FORCED) {
-    // ### --- Forced MODE Setting --- ###
-    uint8_t settings_sel = BME280_SEL_OSR_PRESS | BME280_SEL_OSR_TEMP | BME280_SEL_OSR_HUM | BME280_SEL_FILTER;
-    result = bme280_set_sensor_settings(settings_sel, &_settings, &_dev);
-    bme280_print_error_codes("bme280_set_sensor_settings", result);
-    result = bme280_set_sensor_mode(BME280_POWERMODE_FORCED, &_dev);
-    bme280_print_error_codes("bme280_set_sensor_mode", result);
+void BME::Bosch_BME280::schedulerCallback(void *arg) {
+  Bosch_BME280 *sensor = static_cast<Bosch_BME280 *>(arg);
+  {
+    BME280_CRITICAL_SECTION(sensor->_mux);
+    // without synchronization (e.g. after begin()) the scheduler stops, startScheduler() synchronizes again
+    if (!sensor->_timer_running || !sensor->_cycle_synced) {
+      sensor->_timer_running = false;
+      return;
+    }
+    sensor->_timer_busy = true;
+  }
+  sensor->service();
+  sensor->armScheduler();
+  sensor->_timer_busy = false;
+}
+
+void BME::Bosch_BME280::armScheduler() {
+  // rearm the timer for the read of the next conversion
+  uint32_t due = _cycle_sync + _cycle_period + readOffset();
+  int32_t timeout = (int32_t)(due - micros());
+  esp_timer_start_once(_timer, (timeout > 0) ? (uint64_t)timeout : 1);
+}
+#endif
+
+int8_t BME::Bosch_BME280::measure_forced_mode() {
+  int8_t result = startMeasurement();
+  if (result != BME280_OK) {
+    return result;
+  }
+  if (_status_polling) {
+    // wait until the sensor reports the end of the conversion
+    result = waitForConversion();
+    if (result != BME280_OK) {
+      _measuring = false;
+      return result;
+    }
   }
   else {
-    /* ### --- NORMAL MODE Setting --- ### */
-    _settings.standby_time = BME280_STANDBY_TIME_1000_MS;
-
-    uint8_t settings_sel = BME280_SEL_OSR_PRESS;
-    settings_sel |= BME280_SEL_OSR_TEMP;
-    settings_sel |= BME280_SEL_OSR_HUM;
-    settings_sel |= BME280_SEL_STANDBY;
-    settings_sel |= BME280_SEL_FILTER;
-    result = bme280_set_sensor_settings(settings_sel, &_settings, &_dev);
-    bme280_print_error_codes("bme280_set_sensor_settings", result);
-    result = bme280_set_sensor_mode(BME280_POWERMODE_NORMAL, &_dev);
-    bme280_print_error_codes("bme280_set_sensor_mode", result);
+    // wait request_delay in µs to complete the measurement
+    _dev.delay_us(_period, _dev.intf_ptr);
   }
-  return result;
+  return finishMeasurement();
 }
 
+void BME::Bosch_BME280::setStatusPolling(bool enable, uint16_t interval_us, uint32_t timeout_us) {
+  _status_polling = enable;
+  _poll_interval = interval_us;
+  _poll_timeout = timeout_us;
+  _conversion_time = 0;
+}
 
- void BME::Bosch_BME280::bme280_print_error_codes(const char *api_name, int8_t result) {
+int8_t BME::Bosch_BME280::readMeasuringStatus(bool &measuring) {
+  uint8_t status;
+  int8_t result = bme280_get_regs(BME280_REG_STATUS, &status, 1, &_dev);
+  recordError(ERROR_READ, result);
   if (result != BME280_OK) {
-    Serial.print(api_name);
-    Serial.print("\tError [");
-    switch (result)
+    _reg_cache_valid = false;
+    measuring = false;
+    return result;
+  }
+  // BME280_STATUS_MEAS_DONE is the measuring bit [3], it is set while a conversion is running
+  measuring = (status & BME280_STATUS_MEAS_DONE) != 0;
+  return result;
+}
+
+int8_t BME::Bosch_BME280::waitForConversion() {
+  uint32_t timeout = (_poll_timeout != 0) ? _poll_timeout : _period;
+  uint32_t elapsed;
+  do {
+    // the measuring bit is not set immediately after the trigger, so the first read is after one interval
+    _dev.delay_us(_poll_interval, _dev.intf_ptr);
+    bool measuring;
+    int8_t result = readMeasuringStatus(measuring);
+    elapsed = micros() - _meas_start;
+    if (result != BME280_OK) {
+      return result;
+    }
+    if (!measuring) {
+      _conversion_time = elapsed;
+      return BME280_OK;
+    }
+  } while (elapsed < timeout);
+  recordError(ERROR_CONVERSION, E_MEAS_TIMEOUT);
+  return E_MEAS_TIMEOUT;
+}
+
+int8_t BME::Bosch_BME280::finishMeasurement(uint8_t *status) {
+  _measuring = false;
+  int8_t result = readSensorData(status);
+  _data_ready = (result == BME280_OK);
+  if (_data_ready && _sample_buffer != nullptr && !_raw_capture) {
+    // the buffer has its own critical section
+    _sample_buffer->push(getSampleRecord());
+  }
+  return result;
+}
+
+BME::SampleRecord BME::Bosch_BME280::getSampleRecord() const {
+  // all values of one sample: the getters compensate outside of the critical section,
+  // so the record is taken again if the scheduler task replaced the sample in between
+  SampleRecord record;
+  uint32_t sequence;
+  do {
     {
-      case BME280_E_NULL_PTR:
-          Serial.print(result);
-          Serial.print("] : Null pointer error.\n");
-          Serial.print("\t\t=> It occurs when the user tries to assign value (not address) to a pointer, which has been initialized to NULL.\r\n\n");
-          break;
-
-      case BME280_E_COMM_FAIL:
-          Serial.print(result);
-          Serial.print("] : Communication failure error.\n");
-          Serial.print("\t\t=> It occurs due to read/write operation failure and also due to power failure during communication\r\n\n");
-          break;
-
-      case BME280_E_DEV_NOT_FOUND:
-          Serial.print(result);
-          Serial.print("] : Device not found error.\n");
-          Serial.print("\t\t=> It occurs when the device chip id is incorrectly read\r\n\n");
-          break;
-
-      case BME280_E_INVALID_LEN:
-          Serial.print(result);
-          Serial.print("] : Invalid length error.\n");
-          Serial.print("\t\t=> It occurs when write is done with invalid length\r\n\n");
-          break;
-
-      default:
-          Serial.print(result);
-          Serial.print("] : Unknown error code\r\n\n");
-          break;
-    }
-  }
- }
-
-BME280_INTF_RET_TYPE BME::Bosch_BME280::I2CRead(uint8_t reg_addr, uint8_t *reg_data, uint32_t cnt, void *intf_ptr) {
-  uint8_t dev_addr = *((uint8_t *)intf_ptr);
-  //Serial.println("I2C_bus_read");
-  int8_t result {BME280_OK};
+      BME280_CRITICAL_SECTION(_mux);
+      sequence = _raw_sequence;
+      record.timestamp = _sample_time;
+    }
+    record.pressure = getPressureInt();
+    record.temperature = (int16_t) getTemperatureInt();
+    // 1/1024 % -> 1/100 %
+    record.humidity = (uint16_t) ((getHumidityInt() * 100UL + 512UL) / 1024UL);
+  } while (sequence != rawSequence());
+  return record;
+}
 
-  //Serial.println(dev_addr, HEX);
-  Wire.beginTransmission(dev_addr);
-  
-  //Serial.println(reg_addr, HEX);
-  Wire.write(reg_addr);
-  Wire.endTransmission();
-  
-  Wire.requestFrom((int)dev_addr, (int)cnt);
-  
-  uint8_t available = Wire.available();
-  if(available != cnt) {
-    result = BME280_E_COMM_FAIL;
+struct bme280_uncomp_data BME::Bosch_BME280::getRawData() const {
+  BME280_CRITICAL_SECTION(_mux);
+  return _raw_data;
+}
+
+uint32_t BME::Bosch_BME280::rawSequence() const {
+  BME280_CRITICAL_SECTION(_mux);
+  return _raw_sequence;
+}
+
+int8_t BME::Bosch_BME280::readSensorData(uint8_t *status) {
+  // status register 0xF3, 3 reserved bytes, data registers 0xF7...0xFE
+  const uint8_t status_len {BME280_REG_DATA - BME280_REG_STATUS};
+  // data registers: pressure 0xF7...0xF9, temperature 0xFA...0xFC, humidity 0xFD...0xFE
+  const uint8_t press_len {3}, hum_len {2};
+  // skipped quantities are not read, they keep the value the sensor reports for them (0x80000 resp. 0x8000)
+  uint8_t reg_data[status_len + BME280_LEN_P_T_H_DATA] {0, 0, 0, 0, 0x80, 0, 0, 0, 0, 0, 0x80, 0};
+  uint8_t first = (status != nullptr) ? 0 : status_len;
+  uint8_t end = sizeof(reg_data);
+  if (status == nullptr && _settings.osr_p == BME280_NO_OVERSAMPLING) {
+    first += press_len;
   }
-  
-  for(uint8_t i = 0; i < available; i++) {
-    if(i < cnt) {
-      *(reg_data + i) = Wire.read();
+  if (_settings.osr_h == BME280_NO_OVERSAMPLING) {
+    end -= hum_len;
+  }
+  // burst read of the data registers, the raw values are kept for getRawData()
+  int8_t result = bme280_get_regs(BME280_REG_STATUS + first, reg_data + first, end - first, &_dev);
+  recordError(ERROR_READ, result);
+  if (result != BME280_OK) {
+    _reg_cache_valid = false;
+    return result;
+  }
+  _sample_bytes = end - first;
+  if (status != nullptr) {
+    *status = reg_data[0];
+  }
+  if (_raw_capture) {
+    // the getters keep the values of the last compensated measurement
+    compensate(BME280_ALL);
+  }
+  struct bme280_uncomp_data raw;
+  parseSensorData(reg_data + status_len, &raw);
+  {
+    // the getters may run in another task (ESP32 scheduler), the sample is replaced at once
+    BME280_CRITICAL_SECTION(_mux);
+    _raw_data = raw;
+    ++_raw_sequence;
+    _sample_time = millis();
+    if (!_raw_capture) {
+      _compensation.compensated = 0;
     }
-    else
-      Wire.read();
+  }
+  if (_raw_buffer != nullptr) {
+    _raw_buffer->push(raw);
   }
   return result;
 }
 
-BME280_INTF_RET_TYPE BME::Bosch_BME280::I2CWrite(uint8_t reg_addr, const uint8_t *reg_data, uint32_t cnt, void *intf_ptr) {  
-  uint8_t dev_addr = *((uint8_t *)intf_ptr);
-  int8_t result {BME280_OK};
-  Wire.beginTransmission(dev_addr);
-  Wire.write(reg_addr);
-  Wire.write(reg_data, cnt);
-  Wire.endTransmission();
+struct bme280_data BME::Bosch_BME280::compensate(uint8_t sensor_comp) const {
+  // the scheduler task of the ESP32 replaces the raw data, the sample is copied in the critical section
+  CompensationState state;
+  struct bme280_uncomp_data raw;
+  uint32_t sequence;
+  {
+    BME280_CRITICAL_SECTION(_mux);
+    state = _compensation;
+    if ((sensor_comp & ~state.compensated) == 0) {
+      return state.data;
+    }
+    raw = _raw_data;
+    sequence = _raw_sequence;
+  }
+  compensateMissing(sensor_comp & ~state.compensated, raw, state);
+  // the values are cached unless the sample was replaced during the compensation
+  BME280_CRITICAL_SECTION(_mux);
+  if (sequence == _raw_sequence) {
+    _compensation = state;
+  }
+  return state.data;
+}
+
+void BME::Bosch_BME280::compensateMissing(uint8_t missing, const struct bme280_uncomp_data &raw,
+                                          CompensationState &state) const {
+  // skipped quantities are not measured
+  uint8_t skipped {0};
+  if (_settings.osr_p == BME280_NO_OVERSAMPLING && (missing & BME280_PRESS)) {
+    state.data.pressure = 0;
+    skipped |= BME280_PRESS;
+  }
+  if (_settings.osr_h == BME280_NO_OVERSAMPLING && (missing & BME280_HUM)) {
+    state.data.humidity = 0;
+    skipped |= BME280_HUM;
+  }
+  state.compensated |= skipped;
+  missing &= ~skipped;
+  if (missing == 0) {
+    return;
+  }
+#ifdef BME280_FLOAT_ENABLE
+  // single precision compensation, same formulas and limits as the double compensation, t_fine is cached
+  if (!(state.compensated & BME280_TEMP)) {
+    state.data.temperature = compensateTemperatureFloat(raw.temperature, _dev.calib_data, state.t_fine);
+  }
+  if (missing & BME280_PRESS) {
+    state.data.pressure = compensatePressureFloat(raw.pressure, _dev.calib_data, state.t_fine);
+  }
+  if (missing & BME280_HUM) {
+    state.data.humidity = compensateHumidityFloat(raw.humidity, _dev.calib_data, state.t_fine);
+  }
+#else
+  // the Bosch API always compensates the temperature (t_fine) and clears the quantities not requested
+  struct bme280_calib_data calib = _dev.calib_data;
+  struct bme280_data data;
+  bme280_compensate_data(missing, &raw, &data, &calib);
+  state.data.temperature = data.temperature;
+  if (missing & BME280_PRESS) {
+    state.data.pressure = data.pressure;
+  }
+  if (missing & BME280_HUM) {
+    state.data.humidity = data.humidity;
+  }
+#endif
+  state.compensated |= missing | BME280_TEMP;
+}
+
+void BME::Bosch_BME280::parseSensorData(const uint8_t *reg_data, struct bme280_uncomp_data *raw_data) {
+  // pressure and temperature: 20 bit (msb, lsb, xlsb[7:4]), humidity: 16 bit (msb, lsb)
+  raw_data->pressure = ((uint32_t)reg_data[0] << 12) | ((uint32_t)reg_data[1] << 4) | ((uint32_t)reg_data[2] >> 4);
+  raw_data->temperature = ((uint32_t)reg_data[3] << 12) | ((uint32_t)reg_data[4] << 4) | ((uint32_t)reg_data[5] >> 4);
+  raw_data->humidity = ((uint32_t)reg_data[6] << 8) | (uint32_t)reg_data[7];
+}
+
+int8_t BME::Bosch_BME280::triggerForcedMode() {
+  // fast path: the sensor sleeps after the last conversion, one write of ctrl_meas starts the next one,
+  // if the state of the sensor is unknown all registers are written in the same transaction
+  return writeSettings(!_reg_cache_valid, BME280_POWERMODE_FORCED);
+}
+
+int8_t BME::Bosch_BME280::setSensorSettings() {
+  // all registers with the settings of the constructor or setSettings(),
+  // in forced mode the sensor sleeps until the first measurement
+  return applySettings(_mode == BME280_POWERMODE_FORCED ? BME280_POWERMODE_SLEEP : BME280_POWERMODE_NORMAL);
+}
+
+int8_t BME::Bosch_BME280::setSettings(const Settings &settings) {
+  _requested = settings;
+  return updateSettings();
+}
+
+int8_t BME::Bosch_BME280::setChannels(uint8_t channels) {
+  _channels = channels;
+  return updateSettings();
+}
+
+int8_t BME::Bosch_BME280::updateSettings() {
+  // the temperature is always measured (t_fine), the channels only skip pressure and humidity
+  uint8_t osr_p = (_channels & BME280_PRESS) ? _requested.osr_p : OSR_SKIP;
+  uint8_t osr_h = (_channels & BME280_HUM) ? _requested.osr_h : OSR_SKIP;
+  bool changed = osr_p != _settings.osr_p || _requested.osr_t != _settings.osr_t ||
+                 osr_h != _settings.osr_h || _requested.filter != _settings.filter ||
+                 _requested.standby != _settings.standby_time;
+#ifdef ESP32
+  if (changed && _timer_running) {
+    // the timer task must not read while the settings change and cannot synchronize with the new cycle,
+    // so the scheduler is stopped and synchronized again in the context of the caller
+    stopScheduler();
+    int8_t result = updateSettings();
+    return (result != BME280_OK) ? result : startScheduler();
+  }
+#endif
+  _settings.osr_p = osr_p;
+  _settings.osr_t = _requested.osr_t;
+  _settings.osr_h = osr_h;
+  _settings.filter = _requested.filter;
+  _settings.standby_time = _requested.standby;
+
+  // before begin() the settings are only stored
+  if (!changed || _dev.read == nullptr) {
+    return BME280_OK;
+  }
+  // a running forced conversion is dropped
+  _measuring = false;
+  return applySettings(_mode == BME280_POWERMODE_FORCED ? BME280_POWERMODE_SLEEP : BME280_POWERMODE_NORMAL);
+}
+
+BME::Settings BME::Bosch_BME280::activeSettings() const {
+  return Settings {(Oversampling)_settings.osr_p, (Oversampling)_settings.osr_t, (Oversampling)_settings.osr_h,
+                   (Filter)_settings.filter, (Standby)_settings.standby_time};
+}
+
+int8_t BME::Bosch_BME280::applySettings(uint8_t mode) {
+  // without valid cached registers the state of the sensor is unknown, so all registers are written
+  int8_t result = writeSettings(!_reg_cache_valid, mode);
+
+  // Calculate the minimum delay in µs required between consecutive measurement based upon the sensor enabled
+  // and the oversampling configuration. The settings change only here, so it is done once and not per measurement.
+  bme280_cal_meas_delay(&_period, &_settings);
+
+  if (_mode == BME280_POWERMODE_FORCED) {
+    _cycle_period = 0;
+  }
+  else {
+    // period of the conversion cycle, the scheduler synchronizes again with the new cycle
+    _cycle_period = typicalMeasurementTime(_settings.osr_t, _settings.osr_p, _settings.osr_h) + standbyTime(_settings.standby_time);
+    _cycle_synced = false;
+  }
   return result;
 }
 
-void BME::Bosch_BME280::delay_us(uint32_t period, void *intf_ptr __attribute__((unused))) {
+int8_t BME::Bosch_BME280::writeSettings(bool all, uint8_t mode) {
+  uint8_t ctrl_hum, ctrl_meas, config;
+  buildRegisters(ctrl_hum, ctrl_meas, config);
+  bool hum_changed = all || (ctrl_hum != _reg_ctrl_hum);
+  bool meas_changed = all || (ctrl_meas != _reg_ctrl_meas);
+  bool config_changed = all || (config != _reg_config);
+  // writes to config in normal mode may be ignored, sleep mode is entered by a ctrl_meas write (no soft reset)
+  bool sleep_first = config_changed && (all || _mode == BME280_POWERMODE_NORMAL);
+
+  // register image in the order of the datasheet: ctrl_hum becomes effective with the write of ctrl_meas
+  uint8_t reg_addr[4];
+  uint8_t reg_data[4];
+  uint8_t len {0};
+  if (sleep_first) {
+    reg_addr[len] = BME280_REG_CTRL_MEAS;
+    reg_data[len++] = _reg_ctrl_meas;
+  }
+  if (hum_changed) {
+    reg_addr[len] = BME280_REG_CTRL_HUM;
+    reg_data[len++] = ctrl_hum;
+  }
+  if (config_changed) {
+    reg_addr[len] = BME280_REG_CONFIG;
+    reg_data[len++] = config;
+  }
+  // in normal mode the measurement is restarted, in forced mode a conversion is triggered
+  if (meas_changed || hum_changed || sleep_first || mode == BME280_POWERMODE_FORCED) {
+    reg_addr[len] = BME280_REG_CTRL_MEAS;
+    reg_data[len++] = BME280_SET_BITS_POS_0(ctrl_meas, BME280_SENSOR_MODE, mode);
+  }
+  if (len == 0) {
+    return BME280_OK;
+  }
+
+  // the Bosch API writes all registers as one interleaved burst
+  int8_t result = bme280_set_regs(reg_addr, reg_data, len, &_dev);
+  recordError(ERROR_WRITE, result);
+  if (result == BME280_OK) {
+    _reg_ctrl_hum = ctrl_hum;
+    _reg_ctrl_meas = ctrl_meas;
+    _reg_config = config;
+  }
+  _reg_cache_valid = (result == BME280_OK);
+  return result;
+}
+
+void BME::Bosch_BME280::buildRegisters(uint8_t &ctrl_hum, uint8_t &ctrl_meas, uint8_t &config) const {
+  ctrl_hum = BME280_SET_BITS_POS_0(0, BME280_CTRL_HUM, _settings.osr_h);
+  ctrl_meas = BME280_SET_BITS(0, BME280_CTRL_TEMP, _settings.osr_t);
+  ctrl_meas = BME280_SET_BITS(ctrl_meas, BME280_CTRL_PRESS, _settings.osr_p);
+  config = BME280_SET_BITS(0, BME280_STANDBY, _settings.standby_time);
+  config = BME280_SET_BITS(config, BME280_FILTER, _settings.filter);
+}
+
+ void BME::Bosch_BME280::recordError(ErrorSource source, int8_t result) {
+  if (result != BME280_OK) {
+    ErrorEntry entry = _error_log.record(source, result);
+#ifdef BME280_ERROR_PRINT
+    printError(Serial, entry);
+#else
+    (void) entry;
+#endif
+  }
+}
+
+void BME::Bosch_BME280::delay_us(uint32_t period, void *intf_ptr) {
+  uint32_t start = statsTime();
   delayMicroseconds(period);
+  static_cast<Bosch_BME280 *>(intf_ptr)->recordDelay(start);
 }
\ No newline at end of file
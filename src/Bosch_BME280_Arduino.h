@@ -8,9 +8,173 @@
 #ifndef _BOSCH_BME280_ARDUINO_H_
 #define _BOSCH_BME280_ARDUINO_H_
 #include <Arduino.h>
+#include <Wire.h>
 #include "BME280_API/bme280.h"
+#include "Bosch_BME280_SampleBuffer.h"
+#include "Bosch_BME280_PackedSample.h"
+#include "Bosch_BME280_Compensation.h"
+#include "Bosch_BME280_Transport.h"
+#include "Bosch_BME280_Stats.h"
+#include "Bosch_BME280_Settings.h"
+#include "Bosch_BME280_Calibration.h"
+#include "Bosch_BME280_ErrorLog.h"
+#ifdef ESP32
+#include <esp_timer.h>
+#endif
 
 namespace BME {
+  /**
+   * @brief map the oversampling setting of a register (e.g. BME280_OVERSAMPLING_4X) to the real oversampling factor
+   * 
+   * @param osr oversampling setting
+   * @return oversampling factor (0, 1, 2, 4, 8 or 16)
+   */
+  constexpr uint32_t oversamplingFactor(uint8_t osr) {
+    return (osr == BME280_NO_OVERSAMPLING) ? 0 : (osr <= BME280_OVERSAMPLING_16X) ? (1UL << (osr - 1)) : BME280_OVERSAMPLING_MAX;
+  }
+
+  /**
+   * @brief maximum measurement time in µs, same result as bme280_cal_meas_delay()
+   * 
+   * Can be evaluated at compile time if the oversampling settings are constants, e.g.:
+   * constexpr uint32_t delay_us = BME::measurementDelay(BME280_OVERSAMPLING_1X, BME280_OVERSAMPLING_1X, BME280_OVERSAMPLING_1X);
+   * 
+   * @param osr_t temperature oversampling setting
+   * @param osr_p pressure oversampling setting
+   * @param osr_h humidity oversampling setting
+   * @return measurement time in µs
+   */
+  constexpr uint32_t measurementDelay(uint8_t osr_t, uint8_t osr_p, uint8_t osr_h) {
+    return BME280_MEAS_OFFSET + (BME280_MEAS_DUR * oversamplingFactor(osr_t)) +
+           ((BME280_MEAS_DUR * oversamplingFactor(osr_p)) + BME280_PRES_HUM_MEAS_OFFSET) +
+           ((BME280_MEAS_DUR * oversamplingFactor(osr_h)) + BME280_PRES_HUM_MEAS_OFFSET);
+  }
+
+  /**
+   * @brief typical measurement time of the datasheet in µs, skipped measurements (oversampling 0) take no time
+   * 
+   * @param osr_t temperature oversampling setting
+   * @param osr_p pressure oversampling setting
+   * @param osr_h humidity oversampling setting
+   * @return measurement time in µs
+   */
+  constexpr uint32_t typicalMeasurementTime(uint8_t osr_t, uint8_t osr_p, uint8_t osr_h) {
+    return 1000UL + (2000UL * oversamplingFactor(osr_t)) +
+           ((osr_p != BME280_NO_OVERSAMPLING) ? (2000UL * oversamplingFactor(osr_p)) + 500UL : 0) +
+           ((osr_h != BME280_NO_OVERSAMPLING) ? (2000UL * oversamplingFactor(osr_h)) + 500UL : 0);
+  }
+
+  /**
+   * @brief map the standby setting of the config register (e.g. BME280_STANDBY_TIME_1000_MS) to the standby time
+   * 
+   * @param standby_time standby setting
+   * @return standby time in µs
+   */
+  constexpr uint32_t standbyTime(uint8_t standby_time) {
+    return (standby_time == BME280_STANDBY_TIME_0_5_MS) ? 500UL :
+           (standby_time == BME280_STANDBY_TIME_10_MS) ? 10000UL :
+           (standby_time == BME280_STANDBY_TIME_20_MS) ? 20000UL :
+           62500UL << ((standby_time & 0x07) - 1);
+  }
+
+  namespace detail {
+    // -ln(1 - u) = u + u^2 / 2 + u^3 / 3 + ... (|u| < 0.5)
+    constexpr double negLog1m(double u, double power, uint8_t k) {
+      return (k > 40) ? 0.0 : power / k + negLog1m(u, power * u, k + 1);
+    }
+
+    // least squares fit of 44330 * (1 - (1 + t)^(1 / 5.255)) for t from -0.71 to 0.1, Horner scheme
+    constexpr float altitudePolynomial(float t) {
+      return -0.0862986F + t * (-8444.2948F + t * (3414.7958F + t * (-1058.9884F + t * (7633.0694F +
+             t * (12752.656F + t * 12236.865F)))));
+    }
+
+    // exp(y) = 1 + y + y^2 / 2! + ... (|y| < 4)
+    constexpr double expSeries(double y, double term, uint8_t k) {
+      return (k > 30) ? term : term + expSeries(y, term * y / k, k + 1);
+    }
+  }
+
+  /**
+   * @brief factor from the pressure at an altitude to the pressure at sea level (barometric formula)
+   * 
+   * (1 - altitude / 44330)^-5.255, calculated with series (no pow()), so it is evaluated at compile time
+   * for a constant altitude, e.g.:
+   * constexpr float factor = BME::seaLevelFactor(249.67);
+   * Valid for -5000 m ... 20000 m.
+   * 
+   * @param altitude altitude in meter
+   * @return sea level factor
+   */
+  constexpr float seaLevelFactor(double altitude) {
+    return (float) detail::expSeries(5.255 * detail::negLog1m(altitude / 44330.0, altitude / 44330.0, 1), 1.0, 1);
+  }
+
+  /**
+   * @brief altitude of a pressure for a reference pressure at sea level (inverse barometric formula)
+   * 
+   * 44330 * (1 - (pressure / sealevel)^(1 / 5.255)), approximated by a polynomial of 6th degree in single precision
+   * instead of pow(). Max. error 0.83 m for pressure / sealevel from 0.3 to 1.1 (304 ... 1114 hPa at 1013.25 hPa),
+   * outside of this range the error increases fast.
+   * 
+   * @param pressure air pressure in hPa
+   * @param sealevel reference pressure at sea level in hPa
+   * @return altitude in meter
+   */
+  constexpr float altitudeFromPressure(float pressure, float sealevel = 1013.25F) {
+    return detail::altitudePolynomial(pressure / sealevel - 1.0F);
+  }
+
+  /**
+   * @brief counters of the normal mode scheduler
+   * 
+   */
+  struct SchedulerStats {
+    // number of read conversions
+    uint32_t samples;
+
+    // number of conversions which were not read
+    uint32_t missed;
+
+    // number of reads which returned the data of an already read conversion
+    uint32_t duplicates;
+
+    // number of phase corrections (read during a running conversion outside of the expected phase)
+    uint32_t resyncs;
+  };
+
+  /**
+   * @brief state of a sensor for a fast restart, e.g. after deep sleep (see Bosch_BME280::resume())
+   * 
+   * The structure can be kept in RTC memory (ESP32: RTC_DATA_ATTR) or copied to any other storage.
+   */
+  struct ResumeState {
+    // marker of a valid state
+    uint16_t magic;
+
+    // effective sensor settings (skipped channels have OSR_SKIP)
+    struct bme280_settings settings;
+
+    // settings of setSettings() and channels of setChannels()
+    Settings requested;
+    uint8_t channels;
+
+    // calibration data of the sensor
+    struct bme280_calib_data calib_data;
+  };
+
+  /**
+   * @brief error code of the wrapper: the measuring bit of the status register was not cleared within the timeout
+   * 
+   */
+  constexpr int8_t E_MEAS_TIMEOUT {-20};
+
+  /**
+   * @brief error code of the wrapper: the function is not available in the power mode of the sensor
+   * 
+   */
+  constexpr int8_t E_INVALID_MODE {-21};
+
   class Bosch_BME280 {
     public:
       /**
@@ -19,9 +183,36 @@ namespace BME {
        * @param addr I²C-Address for sensor (0x76 default)
        * @param altitude Altitude for the calculation of the Air Pressure at NN
        * @param forced_mode if true the sensor makes one measurement and goes to sleep (no continuous measurement)
+       * @param wire I²C-Bus of the sensor (Wire default)
+       */
+      explicit Bosch_BME280(uint8_t addr = BME280_I2C_ADDR_PRIM, float altitude = 249.67F, bool forced_mode = true, TwoWire &wire = Wire);
+
+      /**
+       * @brief Construct a new bme::Bosch_BME280 Object on a bus transport
+       * 
+       * The transport (e.g. BME::SPITransport) is a template parameter, its read and write
+       * functions are bound at compile time without virtual dispatch.
+       * 
+       * @tparam Transport transport class, see Bosch_BME280_Transport.h
+       * @param transport transport object, it must exist as long as the sensor object
+       * @param altitude Altitude for the calculation of the Air Pressure at NN
+       * @param forced_mode if true the sensor makes one measurement and goes to sleep (no continuous measurement)
        */
-      explicit Bosch_BME280(uint8_t addr = BME280_I2C_ADDR_PRIM, float altitude = 249.67F, bool forced_mode = true);
+      template <class Transport, class = decltype(&Transport::read)>
+      explicit Bosch_BME280(Transport &transport, float altitude = 249.67F, bool forced_mode = true) :
+        Bosch_BME280(altitude, forced_mode, &transport, Transport::intf,
+                     &busRead<Transport>, &busWrite<Transport>, &busBegin<Transport>)
+      {
+      }
       
+#ifdef ESP32
+      /**
+       * @brief Destroy the bme::Bosch_BME280 Object and delete the esp_timer of the scheduler
+       * 
+       */
+      ~Bosch_BME280();
+#endif
+
       /**
        * @brief setup the I2C Wiring and init the Sensor
        * 
@@ -33,6 +224,30 @@ namespace BME {
        */
       int8_t begin();
 
+      /**
+       * @brief fast restart with a state saved by saveState(), instead of begin()
+       * 
+       * Checks the chip id and restores the calibration data and settings without reading the NVM and
+       * without soft reset. In forced mode the first sample is taken right away (data available on return),
+       * in normal mode the settings are written and the sensor starts converting.
+       * Without valid state (e.g. first boot) begin() is called.
+       * 
+       * @param state saved state
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t resume(const ResumeState &state);
+
+      /**
+       * @brief save the state of the sensor for resume(), e.g. before deep sleep
+       * 
+       * @param state saved state, marked invalid if the sensor was not initialized
+       */
+      void saveState(ResumeState &state) const;
+
       /**
        * @brief measure function
        * 
@@ -43,34 +258,181 @@ namespace BME {
        * @retval  <0: Fail
        */
       int8_t measure();
+
+      /**
+       * @brief start a measurement without waiting for the result
+       * 
+       * In forced mode a conversion is triggered and the function returns immediately.
+       * In normal mode the sensor converts continuously, so the data registers can be read at the next poll().
+       * 
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t startMeasurement();
+
+      /**
+       * @brief finish a measurement started by startMeasurement() if the conversion time has elapsed
+       * 
+       * Call this function cyclic in loop(). It never waits. Without status polling a call costs at most one
+       * transaction, the burst read of the data registers. With status polling (setStatusPolling()) the status
+       * register is read before the predicted measurement time has elapsed, so a call can cost two transactions:
+       * the status register and then the data burst.
+       * 
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t poll();
+
+      /**
+       * @brief check if the data of the last started measurement are available
+       * 
+       * @return true if the getters return the values of the last started measurement
+       */
+      bool isReady() const {return _data_ready;}
+
+      /**
+       * @brief check if a started measurement is still in progress
+       * 
+       * @return true if poll() has to be called until the measurement is finished
+       */
+      bool isMeasuring() const {return _measuring;}
       
+#ifdef BME280_DOUBLE_ENABLE
       /**
        * @brief Get the temperature from the internal BME data object
        * 
        * @return temperature in degree celsius
        */
-      float getTemperature() const {return (float) _bme280_data.temperature;}
+      float getTemperature() const {return (float) compensate(BME280_TEMP).temperature;}
 
       /**
        * @brief Get the Humidity from the internal BME data object
        * 
        * @return humidity in %
        */
-      float getHumidity() const {return (float) _bme280_data.humidity;}
+      float getHumidity() const {return (float) compensate(BME280_HUM).humidity;}
       
       /**
        * @brief Get the air pressure from the internal BME data object
        * 
        * @return air pressure in hecto pascal (hPa)
        */
-      float getPressure() const {return (float) _bme280_data.pressure / 100.0F;}
+      float getPressure() const {return (float) compensate(BME280_PRESS).pressure / 100.0F;}
+
+      /**
+       * @brief Get the temperature as integer from the internal BME data object
+       * 
+       * @return temperature in 1/100 degree celsius
+       */
+      int32_t getTemperatureInt() const {return (int32_t) lround(compensate(BME280_TEMP).temperature * 100.0);}
+
+      /**
+       * @brief Get the humidity as integer from the internal BME data object
+       * 
+       * @return humidity in 1/1024 %
+       */
+      uint32_t getHumidityInt() const {return (uint32_t) lround(compensate(BME280_HUM).humidity * 1024.0);}
+
+      /**
+       * @brief Get the air pressure as integer from the internal BME data object
+       * 
+       * @return air pressure in 1/100 pascal
+       */
+      uint32_t getPressureInt() const {return (uint32_t) lround(compensate(BME280_PRESS).pressure * 100.0);}
+#else
+      /**
+       * @brief Get the temperature from the internal BME data object
+       * 
+       * @return temperature in degree celsius
+       */
+      float getTemperature() const {return (float) getTemperatureInt() / 100.0F;}
+
+      /**
+       * @brief Get the Humidity from the internal BME data object
+       * 
+       * @return humidity in %
+       */
+      float getHumidity() const {return (float) getHumidityInt() / 1024.0F;}
+
+      /**
+       * @brief Get the air pressure from the internal BME data object
+       * 
+       * @return air pressure in hecto pascal (hPa)
+       */
+      float getPressure() const {return (float) getPressureInt() / 10000.0F;}
+
+      /**
+       * @brief Get the temperature as integer from the internal BME data object (no floating point operation)
+       * 
+       * @return temperature in 1/100 degree celsius
+       */
+      int32_t getTemperatureInt() const {return compensate(BME280_TEMP).temperature;}
+
+      /**
+       * @brief Get the humidity as integer from the internal BME data object (no floating point operation)
+       * 
+       * @return humidity in 1/1024 %
+       */
+      uint32_t getHumidityInt() const {return compensate(BME280_HUM).humidity;}
+
+#ifdef BME280_32BIT_ENABLE
+      /**
+       * @brief Get the air pressure as integer from the internal BME data object (no floating point operation)
+       * 
+       * The 32 bit compensation returns pascal, it is scaled to the unit of the 64 bit compensation.
+       * 
+       * @return air pressure in 1/100 pascal
+       */
+      uint32_t getPressureInt() const {return compensate(BME280_PRESS).pressure * 100UL;}
+#else
+      /**
+       * @brief Get the air pressure as integer from the internal BME data object (no floating point operation)
+       * 
+       * @return air pressure in 1/100 pascal
+       */
+      uint32_t getPressureInt() const {return compensate(BME280_PRESS).pressure;}
+#endif
+#endif
       
       /**
        * @brief Get the Sealevel For Altitude from the internal BME data object
        * 
-       * @return sea level for altitude in meter
+       * The factor of the altitude is calculated once by the constructor and setAltitude().
+       * 
+       * @return air pressure at sea level in hecto pascal (hPa)
+       */
+      float getSealevelForAltitude() const {return getPressure() * _sealevel_factor;}
+
+      /**
+       * @brief Get the altitude of the measured pressure for a reference pressure at sea level
+       * 
+       * @param sealevel reference pressure at sea level in hPa
+       * @return altitude in meter, see BME::altitudeFromPressure()
        */
-      float getSealevelForAltitude() const {return (float) _bme280_data.pressure / 100.0 / pow(1.0 - (_altitude / 44330.0), 5.255);}
+      float getAltitudeForSealevel(float sealevel = 1013.25F) const {return altitudeFromPressure(getPressure(), sealevel);}
+
+      /**
+       * @brief set the altitude of the sensor for getSealevelForAltitude()
+       * 
+       * @param altitude altitude in meter
+       */
+      void setAltitude(float altitude) {
+        _altitude = altitude;
+        _sealevel_factor = seaLevelFactor(altitude);
+      }
+
+      /**
+       * @brief Get the altitude of the sensor
+       * 
+       * @return altitude in meter
+       */
+      float getAltitude() const {return _altitude;}
       
       /**
        * @brief Get the sensor status 
@@ -84,78 +446,130 @@ namespace BME {
       int8_t getSensorStatus() const {return _sensor_status;}
 
       /**
-       * @brief set sensor status
+       * @brief Get the log of the last errors
        * 
-       * @param sensor_status 
+       * The errors are recorded without printing, so a failing bus does not block the measurement on the UART.
+       * Print them outside of the measurement with getErrorLog().print(Serial), or compile with BME280_ERROR_PRINT
+       * to print every error immediately.
+       * 
+       * @return error log
        */
-      void setSensorStatus(int8_t sensor_status);
-      
-    private:
+      ErrorLog &getErrorLog() {return _error_log;}
+
       /**
-       * @brief BME280 device structure (internal)
+       * @brief Get the maximum measurement time of the current settings
        * 
+       * The value is calculated once when the settings are applied.
+       * 
+       * @return measurement time in µs
        */
-      struct bme280_dev _dev;
+      uint32_t getMeasurementDelay() const {return _period;}
 
       /**
-       * @brief BME280 data structure (internal)
+       * @brief set oversampling, IIR filter and standby time, e.g. BME::PRESET_INDOOR_NAVIGATION
        * 
-       * holds the measured values
+       * Only the changed registers are written, without bus traffic if nothing changed. Before begin() the settings are stored and
+       * applied by begin(). Default: BME::PRESET_WEATHER_MONITORING.
        * 
+       * @param settings sensor settings
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
        */
-      struct bme280_data _bme280_data;
+      int8_t setSettings(const Settings &settings);
 
       /**
-       * @brief BME280 settings (internal)
+       * @brief Get the sensor settings
        * 
+       * @return sensor settings as set by setSettings() (without the channels disabled by setChannels())
        */
-      struct bme280_settings _settings;
-      
+      Settings getSettings() const {return _requested;}
+
       /**
-       * @brief member for delay time in µs
+       * @brief select the measured quantities, the oversampling of the other ones is set to skipped
+       * 
+       * Skipped quantities shorten the measurement time and the supply current, they are not read from the sensor
+       * and their getters return 0. The temperature is always measured, the compensation of pressure and humidity
+       * needs it. Like setSettings() only changed registers are written. Default: BME280_ALL.
        * 
+       * @param channels BME280_PRESS, BME280_TEMP and BME280_HUM combined with |, e.g. BME280_TEMP | BME280_HUM
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
        */
-      uint32_t _period;
-      
+      int8_t setChannels(uint8_t channels);
+
       /**
-       * @brief internal member for altitude
+       * @brief Get the measured quantities
        * 
+       * @return channels as set by setChannels()
        */
-      float _altitude;
+      uint8_t getChannels() const {return _channels;}
 
       /**
-       * @brief internal member for sensor status
+       * @brief Get the typical output data rate, current and pressure noise of the current settings, channels and mode
        * 
+       * @param interval_ms time between two measurements in forced mode in ms
+       * @return report, see BME::evaluateSettings()
        */
-      int8_t _sensor_status;
+      SettingsReport getSettingsReport(uint32_t interval_ms = 1000) const {
+        return evaluateSettings(activeSettings(), _mode == BME280_POWERMODE_FORCED, interval_ms);
+      }
 
-      // internal members for address and mode
-      uint8_t _addr, _mode;
+      /**
+       * @brief enable or disable polling of the status register in forced mode
+       * 
+       * Instead of waiting the predicted maximum measurement time, measure() polls the measuring bit
+       * of the status register (0xF3), so the latency follows the real conversion time.
+       * poll() reads the status register at most once per interval before the maximum time has elapsed.
+       * 
+       * @param enable true to poll the status register
+       * @param interval_us time between two reads of the status register in µs
+       * @param timeout_us maximum wait time of measure() in µs, 0 for getMeasurementDelay()
+       */
+      void setStatusPolling(bool enable, uint16_t interval_us = 500, uint32_t timeout_us = 0);
 
       /**
-       * @brief set sensor settings for forced or normal mode of BME280
+       * @brief Get the conversion time of the last measurement with status polling
        * 
-       * @return sensor status
+       * Compare with the predicted maximum of getMeasurementDelay().
        * 
-       * @retval   0: Success
-       * @retval  >0: Warning
-       * @retval  <0: Fail
+       * @return measured conversion time in µs (resolution: poll interval), 0 if not measured
        */
-      int8_t setSensorSettings();
-      
+      uint32_t getMeasuredConversionTime() const {return _conversion_time;}
+
       /**
-       * @brief measurement in normal mode
+       * @brief Get the period of the normal mode (typical measurement time + standby time)
+       * 
+       * @return period in µs, 0 in forced mode
+       */
+      uint32_t getNormalModePeriod() const {return _cycle_period;}
+
+      /**
+       * @brief synchronize the normal mode scheduler with the conversion cycle of the sensor
+       * 
+       * Polls the status register until the end of a conversion, this blocks up to one period.
+       * The found conversion is not read, the next measure() or service() reads it as a new sample.
        * 
        * @return sensor status
        *
        * @retval   0: Success
        * @retval  >0: Warning
-       * @retval  <0: Fail
-     */
-      int8_t measure_normal_mode();
+       * @retval  <0: Fail (E_INVALID_MODE in forced mode, E_MEAS_TIMEOUT if no conversion ended)
+       */
+      int8_t synchronize();
 
       /**
-       * @brief measure in forced mode. In forced mode the sensor takes one measurement and then goes to sleep
+       * @brief normal mode scheduler: read each conversion of the sensor once
+       * 
+       * Call this function cyclic (e.g. in loop() or a timer task), it reads the data registers only
+       * once per period, between two conversions. Conversions which were not read are counted as missed.
+       * The first call synchronizes with the sensor (see synchronize()).
+       * measure() in normal mode counts a duplicate if it returns the data of an already read conversion.
        * 
        * @return sensor status
        *
@@ -163,54 +577,777 @@ namespace BME {
        * @retval  >0: Warning
        * @retval  <0: Fail
        */
-      int8_t measure_forced_mode();
+      int8_t service();
 
       /**
-       * @brief print the bme280 specific error codes
+       * @brief Get the counters of the normal mode scheduler
        * 
-       * @param api_name name of api
-       * @param result code or result
+       * @return counters
        */
-      void bme280_print_error_codes(const char *api_name, int8_t result);
+      const SchedulerStats &getSchedulerStats() const {return _scheduler_stats;}
 
+#ifdef ESP32
       /**
-       * @brief User defined function for I2C Read
+       * @brief start the normal mode scheduler on an esp_timer (ESP32 only)
        * 
-       * @param reg_addr Register Address
-       * @param reg_data Register Data
-       * @param cnt count of Bytes
-       * @param intf_ptr Pointer of user defined function
+       * Synchronizes with the sensor and reads the first conversion in the context of the caller (blocks up to
+       * two periods), then the timer callback calls service() once per period and is rearmed for the next conversion.
+       * The data are updated in the esp_timer task under a critical section: the getters, getSampleRecord(),
+       * getRawData() and the drain() of the sample buffers may be used in loop(), measure() and poll() not.
+       * setSettings() and setChannels() stop the scheduler and start it again with the new cycle,
+       * after begin() or resume() the scheduler stops and has to be started again.
        * 
-       * @return sensor communication status
+       * @return sensor status
        *
        * @retval   0: Success
-       * @retval  >0: Warning
        * @retval  <0: Fail
        */
-      static BME280_INTF_RET_TYPE I2CRead(uint8_t reg_addr, uint8_t *reg_data, uint32_t cnt, void *intf_ptr);
+      int8_t startScheduler();
 
       /**
-       * @brief User defined function for I2C Write
+       * @brief stop the esp_timer of the normal mode scheduler (ESP32 only)
        * 
-       * @param reg_addr Register Address
-       * @param reg_data Register Data
-       * @param cnt count of Bytes
-       * @param intf_ptr Pointer of user defined function
-       *
-       * @return sensor communication status
-       *
-       * @retval   0: Success.
-       * @retval  >0: Warning.
-       * @retval  <0: Fail.
+       * Waits for the end of a running timer callback.
        */
-      static BME280_INTF_RET_TYPE I2CWrite(uint8_t reg_addr, const uint8_t *reg_data, uint32_t cnt, void *intf_ptr);
+      void stopScheduler();
+#endif
 
       /**
-       * @brief User defined function for delay of micros 
+       * @brief set a ring buffer which receives a record of every successful measurement
        * 
-       * @param period count of micro seconds
+       * Works with measure() as well as with startMeasurement()/poll().
+       * 
+       * @param buffer pointer to a BME::SampleBuffer<N>, nullptr to disable recording
        */
-      static void delay_us(uint32_t period, void *intf_ptr);
+      void setSampleBuffer(SampleBufferBase *buffer) {_sample_buffer = buffer;}
+
+      /**
+       * @brief Get a compact timestamped record of the last measurement
+       * 
+       * @return sample record
+       */
+      SampleRecord getSampleRecord() const;
+
+      /**
+       * @brief Get the raw (uncompensated) ADC values of the last measurement
+       * 
+       * pressure and temperature are 20 bit, humidity is 16 bit
+       * 
+       * @return raw data structure of the Bosch API
+       */
+      struct bme280_uncomp_data getRawData() const;
+
+      /**
+       * @brief Get the number of bytes read by the data burst of the last measurement
+       * 
+       * 8 bytes with all quantities, without pressure the read starts at 0xFA (-3 bytes), without humidity
+       * it ends at 0xFC (-2 bytes). service() reads the status register, 3 reserved bytes and the pressure in front
+       * (12 bytes with all quantities), status polling reads the status register in a separate 1 byte transaction.
+       * 
+       * @return bytes of the last data burst read (without the register address)
+       */
+      uint8_t getSampleBytes() const {return _sample_bytes;}
+
+      /**
+       * @brief set a ring buffer which receives the raw values of every successful measurement
+       * 
+       * @param buffer pointer to a BME::RawSampleBuffer<N>, nullptr to disable recording
+       */
+      void setRawSampleBuffer(RawSampleBufferBase *buffer) {_raw_buffer = buffer;}
+
+      /**
+       * @brief enable or disable the raw capture mode
+       * 
+       * In raw capture mode the measurement only reads and stores the raw values, the compensation
+       * is deferred (e.g. BME::compensateSamples() with getCalibData()). The float and integer getters
+       * and the sample buffer are not updated in this mode.
+       * 
+       * @param enable true for raw capture mode
+       */
+      void setRawCapture(bool enable) {_raw_capture = enable;}
+
+      /**
+       * @brief Get the calibration data read from the sensor in begin()
+       * 
+       * @return calibration data structure of the Bosch API
+       */
+      const struct bme280_calib_data &getCalibData() const {return _dev.calib_data;}
+
+      /**
+       * @brief set the calibration data of the sensor, e.g. from BME::deserializeCalibData()
+       * 
+       * If called before begin(), begin() does not read the calibration data from the NVM of the sensor.
+       * 
+       * @param calib calibration data of this sensor
+       */
+      void setCalibData(const struct bme280_calib_data &calib);
+
+      /**
+       * @brief set sensor status
+       * 
+       * @param sensor_status 
+       */
+      void setSensorStatus(int8_t sensor_status);
+
+#ifdef BME280_STATS_ENABLE
+      /**
+       * @brief Get the bus statistics (only with BME280_STATS_ENABLE)
+       * 
+       * Counts transactions, bytes, bus errors, time on the bus and time in delay
+       * per public API function, e.g. getStats().api[BME::STATS_MEASURE].
+       * 
+       * @return statistics
+       */
+      const Stats &getStats() const {return _stats;}
+
+      /**
+       * @brief reset the bus statistics (only with BME280_STATS_ENABLE)
+       * 
+       */
+      void resetStats();
+#endif
+      
+    private:
+      /**
+       * @brief BME280 device structure (internal)
+       * 
+       */
+      struct bme280_dev _dev;
+
+      /**
+       * @brief compensated values of one raw sample (internal)
+       * 
+       */
+      struct CompensationState {
+        // compensated values, filled by the getters on first access (see compensate())
+        struct bme280_data data;
+
+        // quantities of data which are compensated from the raw sample (BME280_PRESS | BME280_TEMP | BME280_HUM)
+        uint8_t compensated;
+
+#ifdef BME280_FLOAT_ENABLE
+        // fine temperature of the raw sample for the pressure and humidity compensation
+        int32_t t_fine;
+#endif
+      };
+
+      /**
+       * @brief compensated values of _raw_data (internal)
+       * 
+       */
+      mutable CompensationState _compensation;
+
+      /**
+       * @brief number of raw samples read, a compensation is only stored if the sample was not replaced meanwhile
+       * 
+       */
+      uint32_t _raw_sequence;
+
+      /**
+       * @brief BME280 raw data structure (internal)
+       * 
+       * holds the uncompensated ADC values of the last measurement
+       * 
+       */
+      struct bme280_uncomp_data _raw_data;
+
+      /**
+       * @brief BME280 settings (internal)
+       * 
+       */
+      struct bme280_settings _settings;
+
+      /**
+       * @brief settings of setSettings(), _settings additionally skips the channels which are not selected
+       * 
+       */
+      Settings _requested;
+
+      /**
+       * @brief measured quantities (BME280_PRESS | BME280_TEMP | BME280_HUM)
+       * 
+       */
+      uint8_t _channels;
+      
+      /**
+       * @brief member for delay time in µs, calculated when the settings are applied
+       * 
+       */
+      uint32_t _period;
+      
+      /**
+       * @brief internal member for altitude
+       * 
+       */
+      float _altitude;
+
+      /**
+       * @brief factor from the pressure at _altitude to the pressure at sea level
+       * 
+       */
+      float _sealevel_factor;
+
+      /**
+       * @brief internal member for sensor status
+       * 
+       */
+      int8_t _sensor_status;
+
+      // internal member for mode
+      uint8_t _mode;
+
+      /**
+       * @brief I²C transport used by the address constructor
+       * 
+       */
+      I2CTransport _i2c;
+
+      /**
+       * @brief transport object and its statically bound functions
+       * 
+       */
+      void *_transport;
+      enum bme280_intf _intf;
+      bme280_read_fptr_t _bus_read;
+      bme280_write_fptr_t _bus_write;
+      int8_t (*_bus_begin)(void *transport);
+
+      /**
+       * @brief timestamp in µs of the last started measurement
+       * 
+       */
+      uint32_t _meas_start;
+
+      /**
+       * @brief internal members for the state of a non-blocking measurement
+       * 
+       */
+      bool _measuring, _data_ready;
+
+      /**
+       * @brief cached content of the ctrl_meas register (power mode bits = sleep)
+       * 
+       * In forced mode the sensor returns to sleep after each conversion, so a new
+       * conversion is triggered by a single write of this value with the forced mode bits.
+       */
+      uint8_t _reg_ctrl_meas;
+
+      /**
+       * @brief cached content of the ctrl_hum and config registers
+       * 
+       * Together with _reg_ctrl_meas a shadow copy of the configuration, new settings are written as diff.
+       */
+      uint8_t _reg_ctrl_hum, _reg_config;
+
+      /**
+       * @brief true if the cached registers match the sensor, false after a bus error
+       * 
+       */
+      bool _reg_cache_valid;
+
+      /**
+       * @brief optional ring buffer for the measured samples
+       * 
+       */
+      SampleBufferBase *_sample_buffer;
+
+      /**
+       * @brief optional ring buffer for the raw samples
+       * 
+       */
+      RawSampleBufferBase *_raw_buffer;
+
+      /**
+       * @brief true if the compensation is deferred
+       * 
+       */
+      bool _raw_capture;
+
+      /**
+       * @brief timestamp in ms of the last successful measurement
+       * 
+       */
+      uint32_t _sample_time;
+
+      /**
+       * @brief bytes read by the data burst of the last measurement
+       * 
+       */
+      uint8_t _sample_bytes;
+
+      /**
+       * @brief settings of the status register polling
+       * 
+       */
+      bool _status_polling;
+      uint16_t _poll_interval;
+      uint32_t _poll_timeout;
+
+      /**
+       * @brief timestamp in µs of the last status register read of poll()
+       * 
+       */
+      uint32_t _status_poll_time;
+
+      /**
+       * @brief measured conversion time in µs of the last measurement with status polling
+       * 
+       */
+      uint32_t _conversion_time;
+
+      /**
+       * @brief state of the normal mode scheduler
+       * 
+       * _cycle_sync is the end of the last read conversion, the following conversions end every _cycle_period µs.
+       * After synchronize() it is the end of the found conversion, which is marked by _cycle_unread until it is read.
+       */
+      uint32_t _cycle_period;
+      uint32_t _cycle_sync;
+      bool _cycle_synced, _cycle_unread;
+      SchedulerStats _scheduler_stats;
+
+#ifdef ESP32
+      /**
+       * @brief esp_timer of the normal mode scheduler
+       * 
+       */
+      esp_timer_handle_t _timer;
+      bool _timer_running;
+
+      /**
+       * @brief lock of the data shared by the esp_timer task and loop() (raw data, compensated values, sample state)
+       * 
+       */
+      mutable portMUX_TYPE _mux;
+
+      /**
+       * @brief true while the timer callback runs, stopScheduler() waits for the end of the callback
+       * 
+       */
+      volatile bool _timer_busy;
+#endif
+
+#ifdef BME280_STATS_ENABLE
+      /**
+       * @brief bus statistics and the API function which is currently running
+       * 
+       */
+      Stats _stats;
+      StatsApi _stats_api;
+#endif
+
+      /**
+       * @brief assigns the bus traffic to an API function while it is running
+       * 
+       * Empty without BME280_STATS_ENABLE.
+       */
+      class StatsScope {
+        public:
+#ifdef BME280_STATS_ENABLE
+          StatsScope(Bosch_BME280 *sensor, StatsApi api) : _sensor {sensor}, _previous {sensor->_stats_api} {
+            // nested calls are counted for the outer call
+            if (_previous == STATS_OTHER) {
+              sensor->_stats_api = api;
+              ++sensor->_stats.api[api].calls;
+            }
+          }
+          ~StatsScope() {_sensor->_stats_api = _previous;}
+        private:
+          Bosch_BME280 *_sensor;
+          StatsApi _previous;
+#else
+          StatsScope(Bosch_BME280 *sensor __attribute__((unused)), StatsApi api __attribute__((unused))) {}
+#endif
+      };
+
+      /**
+       * @brief true if the calibration data were set by setCalibData()
+       * 
+       */
+      bool _calib_loaded;
+
+      /**
+       * @brief last errors and error counters
+       * 
+       */
+      ErrorLog _error_log;
+
+      /**
+       * @brief check the chip id, soft reset and read the calibration data if they are not loaded
+       * 
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t initSensor();
+
+      /**
+       * @brief setup the bus of the transport and the bus functions of the Bosch API
+       * 
+       * @return transport status
+       */
+      int8_t beginBus();
+
+      /**
+       * @brief set sensor settings for forced or normal mode of BME280
+       * 
+       * @return sensor status
+       * 
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t setSensorSettings();
+
+      /**
+       * @brief calculate _settings of the requested settings and channels and apply them if changed
+       * 
+       * @return sensor status
+       * 
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t updateSettings();
+
+      /**
+       * @brief settings used by the sensor
+       * 
+       * @return _settings as typed settings
+       */
+      Settings activeSettings() const;
+
+      /**
+       * @brief write _settings to the sensor and update the values which depend on the settings
+       * 
+       * @param mode power mode after the write (forced mode: sleep, or forced to start a conversion)
+       * @return sensor status
+       * 
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t applySettings(uint8_t mode);
+
+      /**
+       * @brief write the configuration registers in one interleaved burst
+       * 
+       * Only the registers which differ from the cached registers are written, ctrl_meas is written last
+       * (ctrl_hum becomes effective with the write of ctrl_meas). A config change in normal mode or an
+       * unknown sensor state puts the sensor to sleep first, in the same burst.
+       * 
+       * @param all true if the state of the sensor is unknown, all registers are written
+       * @param mode power mode of the last ctrl_meas write, BME280_POWERMODE_FORCED always writes ctrl_meas
+       * @return sensor status
+       * 
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t writeSettings(bool all, uint8_t mode);
+
+      /**
+       * @brief build the content of the configuration registers from _settings (power mode bits = sleep)
+       * 
+       * @param ctrl_hum content of ctrl_hum
+       * @param ctrl_meas content of ctrl_meas
+       * @param config content of config
+       */
+      void buildRegisters(uint8_t &ctrl_hum, uint8_t &ctrl_meas, uint8_t &config) const;
+      
+      /**
+       * @brief measurement in normal mode
+       * 
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+     */
+      int8_t measure_normal_mode();
+
+      /**
+       * @brief measure in forced mode. In forced mode the sensor takes one measurement and then goes to sleep
+       * 
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t measure_forced_mode();
+
+      /**
+       * @brief read the data registers of the sensor, the compensation is done by the getters
+       * 
+       * @param status if not nullptr the status register is read in the same burst (0xF3...0xFE)
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t readSensorData(uint8_t *status = nullptr);
+
+      /**
+       * @brief parse the burst read data registers into the raw ADC values
+       * 
+       * @param reg_data 8 bytes of the data registers 0xF7...0xFE
+       * @param raw_data raw data structure
+       */
+      static void parseSensorData(const uint8_t *reg_data, struct bme280_uncomp_data *raw_data);
+
+      /**
+       * @brief compensate the quantities of the last measurement which are not yet compensated
+       * 
+       * The measurement only stores the raw values, each quantity is compensated on the first call of
+       * its getter and cached until the next measurement. On the ESP32 the sample is copied in a critical
+       * section and compensated outside of it, so a getter never sees a half written sample of the scheduler
+       * task and the scheduler task is not blocked by the compensation.
+       * 
+       * @param sensor_comp BME280_PRESS, BME280_TEMP, BME280_HUM or BME280_ALL
+       * @return copy of the compensated values
+       */
+      struct bme280_data compensate(uint8_t sensor_comp) const;
+
+      /**
+       * @brief compensate the given quantities of a raw sample, called by compensate()
+       * 
+       * @param missing quantities which are not yet compensated
+       * @param raw raw sample
+       * @param state compensated values of the raw sample, updated with the missing quantities
+       */
+      void compensateMissing(uint8_t missing, const struct bme280_uncomp_data &raw, CompensationState &state) const;
+
+      /**
+       * @brief Get the number of raw samples read, read in the critical section of the scheduler
+       * 
+       * @return number of raw samples
+       */
+      uint32_t rawSequence() const;
+
+      /**
+       * @brief read the measuring bit of the status register
+       * 
+       * @param measuring true while a conversion is running
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t readMeasuringStatus(bool &measuring);
+
+      /**
+       * @brief wait until the measuring bit of the status register is cleared
+       * 
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail (E_MEAS_TIMEOUT if the timeout has elapsed)
+       */
+      int8_t waitForConversion();
+
+      /**
+       * @brief time of the scheduled read after the end of a conversion, in the middle of the standby time
+       * 
+       * @return offset in µs
+       */
+      uint32_t readOffset() const {return standbyTime(_settings.standby_time) / 2;}
+
+      /**
+       * @brief count the conversions since the last scheduled read and move the cycle reference
+       * 
+       * @param now current time in µs
+       * @return number of conversions which ended since the last read (0: duplicate, >1: missed conversions),
+       *         the conversion found by synchronize() counts as well if it was not read
+       */
+      uint32_t advanceCycle(uint32_t now);
+
+#ifdef ESP32
+      /**
+       * @brief callback of the esp_timer
+       * 
+       * @param arg Pointer of the Bosch_BME280 object
+       */
+      static void schedulerCallback(void *arg);
+
+      /**
+       * @brief arm the esp_timer for the read of the next conversion
+       * 
+       */
+      void armScheduler();
+#endif
+
+      /**
+       * @brief trigger a forced mode conversion
+       * 
+       * Uses one register write if the cached register content is valid, otherwise
+       * all configuration registers are written in the same transaction.
+       * 
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t triggerForcedMode();
+
+      /**
+       * @brief read the data of a started measurement and update the measurement state
+       * 
+       * @param status if not nullptr the status register is read in the same burst
+       * @return sensor status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t finishMeasurement(uint8_t *status = nullptr);
+
+      /**
+       * @brief record an error in the error log, with BME280_ERROR_PRINT it is printed to Serial as well
+       * 
+       * @param source function which reported the error
+       * @param result code or result, BME280_OK is not recorded
+       */
+      void recordError(ErrorSource source, int8_t result);
+
+      /**
+       * @brief common constructor of the public constructors
+       * 
+       * @param altitude Altitude for the calculation of the Air Pressure at NN
+       * @param forced_mode if true the sensor makes one measurement and goes to sleep
+       * @param transport transport object, nullptr for the internal I²C transport
+       * @param intf interface type of the transport
+       * @param bus_read read function of the transport
+       * @param bus_write write function of the transport
+       * @param bus_begin begin function of the transport
+       */
+      Bosch_BME280(float altitude, bool forced_mode, void *transport, enum bme280_intf intf,
+                   bme280_read_fptr_t bus_read, bme280_write_fptr_t bus_write, int8_t (*bus_begin)(void *transport));
+
+      /**
+       * @brief User defined function for bus read, calls the read function of the transport
+       * 
+       * @tparam Transport transport class
+       * @param reg_addr Register Address
+       * @param reg_data Register Data
+       * @param cnt count of Bytes
+       * @param intf_ptr Pointer of the Bosch_BME280 object
+       * 
+       * @return sensor communication status
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      template <class Transport>
+      static BME280_INTF_RET_TYPE busRead(uint8_t reg_addr, uint8_t *reg_data, uint32_t cnt, void *intf_ptr) {
+        Bosch_BME280 *sensor = static_cast<Bosch_BME280 *>(intf_ptr);
+        uint32_t start = statsTime();
+        BME280_INTF_RET_TYPE result = static_cast<Transport *>(sensor->_transport)->read(reg_addr, reg_data, cnt);
+        sensor->recordBus(false, cnt, result, start);
+        return result;
+      }
+
+      /**
+       * @brief User defined function for bus write, calls the write function of the transport
+       * 
+       * @tparam Transport transport class
+       * @param reg_addr Register Address
+       * @param reg_data Register Data
+       * @param cnt count of Bytes
+       * @param intf_ptr Pointer of the Bosch_BME280 object
+       *
+       * @return sensor communication status
+       *
+       * @retval   0: Success.
+       * @retval  >0: Warning.
+       * @retval  <0: Fail.
+       */
+      template <class Transport>
+      static BME280_INTF_RET_TYPE busWrite(uint8_t reg_addr, const uint8_t *reg_data, uint32_t cnt, void *intf_ptr) {
+        Bosch_BME280 *sensor = static_cast<Bosch_BME280 *>(intf_ptr);
+        uint32_t start = statsTime();
+        BME280_INTF_RET_TYPE result = static_cast<Transport *>(sensor->_transport)->write(reg_addr, reg_data, cnt);
+        sensor->recordBus(true, cnt, result, start);
+        return result;
+      }
+
+      /**
+       * @brief calls the begin function of the transport
+       * 
+       * @tparam Transport transport class
+       * @param transport transport object
+       * @return transport status
+       */
+      template <class Transport>
+      static int8_t busBegin(void *transport) {
+        return static_cast<Transport *>(transport)->begin();
+      }
+
+      /**
+       * @brief User defined function for delay of micros 
+       * 
+       * @param period count of micro seconds
+       * @param intf_ptr Pointer of the Bosch_BME280 object
+       */
+      static void delay_us(uint32_t period, void *intf_ptr);
+
+      /**
+       * @brief timestamp for the statistics
+       * 
+       * @return micros() with BME280_STATS_ENABLE, else 0
+       */
+      static uint32_t statsTime() {
+#ifdef BME280_STATS_ENABLE
+        return micros();
+#else
+        return 0;
+#endif
+      }
+
+      /**
+       * @brief record a bus transaction in the statistics (empty without BME280_STATS_ENABLE)
+       * 
+       * @param write true for a write transaction
+       * @param cnt count of Bytes
+       * @param result result of the transaction
+       * @param start statsTime() at the start of the transaction
+       */
+      void recordBus(bool write __attribute__((unused)), uint32_t cnt __attribute__((unused)),
+                     BME280_INTF_RET_TYPE result __attribute__((unused)), uint32_t start __attribute__((unused))) {
+#ifdef BME280_STATS_ENABLE
+        ApiStats &stats = _stats.api[_stats_api];
+        if (write) {
+          ++stats.writes;
+          stats.write_bytes += cnt;
+        }
+        else {
+          ++stats.reads;
+          stats.read_bytes += cnt;
+        }
+        if (result != BME280_INTF_RET_SUCCESS) {
+          ++stats.errors;
+        }
+        stats.bus_us += micros() - start;
+#endif
+      }
+
+      /**
+       * @brief record the time of a delay in the statistics (empty without BME280_STATS_ENABLE)
+       * 
+       * @param start statsTime() at the start of the delay
+       */
+      void recordDelay(uint32_t start __attribute__((unused))) {
+#ifdef BME280_STATS_ENABLE
+        _stats.api[_stats_api].delay_us += micros() - start;
+#endif
+      }
   };
 }
 #endif
@@ -0,0 +1,90 @@
+/**
+ * @file    Bosch_BME280_Calibration.cpp
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Export and import of the BME280 calibration data with integrity check
+ */
+#include <Bosch_BME280_Calibration.h>
+
+namespace {
+  // version of the serialized layout
+  const uint8_t CALIB_FORMAT_VERSION {1};
+
+  // offset of the CRC
+  const uint8_t CALIB_CRC_OFFSET {BME::CALIB_DATA_SIZE - 2};
+
+  void putUint16(uint8_t *&buffer, uint16_t value) {
+    *buffer++ = (uint8_t)value;
+    *buffer++ = (uint8_t)(value >> 8);
+  }
+
+  uint16_t getUint16(const uint8_t *&buffer) {
+    uint16_t value = (uint16_t)buffer[0] | ((uint16_t)buffer[1] << 8);
+    buffer += 2;
+    return value;
+  }
+}
+
+void BME::serializeCalibData(const struct bme280_calib_data &calib, uint8_t *buffer) {
+  uint8_t *data = buffer;
+  *data++ = CALIB_FORMAT_VERSION;
+  putUint16(data, calib.dig_t1);
+  putUint16(data, (uint16_t)calib.dig_t2);
+  putUint16(data, (uint16_t)calib.dig_t3);
+  putUint16(data, calib.dig_p1);
+  putUint16(data, (uint16_t)calib.dig_p2);
+  putUint16(data, (uint16_t)calib.dig_p3);
+  putUint16(data, (uint16_t)calib.dig_p4);
+  putUint16(data, (uint16_t)calib.dig_p5);
+  putUint16(data, (uint16_t)calib.dig_p6);
+  putUint16(data, (uint16_t)calib.dig_p7);
+  putUint16(data, (uint16_t)calib.dig_p8);
+  putUint16(data, (uint16_t)calib.dig_p9);
+  *data++ = calib.dig_h1;
+  putUint16(data, (uint16_t)calib.dig_h2);
+  *data++ = calib.dig_h3;
+  putUint16(data, (uint16_t)calib.dig_h4);
+  putUint16(data, (uint16_t)calib.dig_h5);
+  *data++ = (uint8_t)calib.dig_h6;
+  putUint16(data, crc16(buffer, CALIB_CRC_OFFSET));
+}
+
+bool BME::deserializeCalibData(const uint8_t *buffer, struct bme280_calib_data &calib) {
+  const uint8_t *crc = buffer + CALIB_CRC_OFFSET;
+  if (buffer[0] != CALIB_FORMAT_VERSION || getUint16(crc) != crc16(buffer, CALIB_CRC_OFFSET)) {
+    return false;
+  }
+  const uint8_t *data = buffer + 1;
+  calib.dig_t1 = getUint16(data);
+  calib.dig_t2 = (int16_t)getUint16(data);
+  calib.dig_t3 = (int16_t)getUint16(data);
+  calib.dig_p1 = getUint16(data);
+  calib.dig_p2 = (int16_t)getUint16(data);
+  calib.dig_p3 = (int16_t)getUint16(data);
+  calib.dig_p4 = (int16_t)getUint16(data);
+  calib.dig_p5 = (int16_t)getUint16(data);
+  calib.dig_p6 = (int16_t)getUint16(data);
+  calib.dig_p7 = (int16_t)getUint16(data);
+  calib.dig_p8 = (int16_t)getUint16(data);
+  calib.dig_p9 = (int16_t)getUint16(data);
+  calib.dig_h1 = *data++;
+  calib.dig_h2 = (int16_t)getUint16(data);
+  calib.dig_h3 = *data++;
+  calib.dig_h4 = (int16_t)getUint16(data);
+  calib.dig_h5 = (int16_t)getUint16(data);
+  calib.dig_h6 = (int8_t)*data++;
+  calib.t_fine = 0;
+  return true;
+}
+
+uint16_t BME::crc16(const uint8_t *data, uint16_t len) {
+  uint16_t crc {0xFFFF};
+  for (uint16_t i = 0; i < len; ++i) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (uint8_t bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
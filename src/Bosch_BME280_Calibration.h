@@ -0,0 +1,47 @@
+/**
+ * @file    Bosch_BME280_Calibration.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Export and import of the BME280 calibration data with integrity check
+ */
+#ifndef _BOSCH_BME280_CALIBRATION_H_
+#define _BOSCH_BME280_CALIBRATION_H_
+#include <Arduino.h>
+#include "BME280_API/bme280.h"
+
+namespace BME {
+  /**
+   * @brief size of serialized calibration data in bytes
+   * 
+   * Layout: format version, 33 bytes calibration values (dig_t1...dig_h6, little endian), CRC-16 (little endian).
+   */
+  const uint8_t CALIB_DATA_SIZE {36};
+
+  /**
+   * @brief serialize calibration data with a CRC
+   * 
+   * @param calib calibration data (e.g. Bosch_BME280::getCalibData())
+   * @param buffer destination, CALIB_DATA_SIZE bytes
+   */
+  void serializeCalibData(const struct bme280_calib_data &calib, uint8_t *buffer);
+
+  /**
+   * @brief deserialize calibration data serialized by serializeCalibData()
+   * 
+   * @param buffer source, CALIB_DATA_SIZE bytes
+   * @param calib calibration data, unchanged if the check fails
+   * @return false if the format version or the CRC does not match
+   */
+  bool deserializeCalibData(const uint8_t *buffer, struct bme280_calib_data &calib);
+
+  /**
+   * @brief CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF)
+   * 
+   * @param data data
+   * @param len count of bytes
+   * @return CRC
+   */
+  uint16_t crc16(const uint8_t *data, uint16_t len);
+}
+#endif
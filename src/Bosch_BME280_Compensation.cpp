@@ -0,0 +1,107 @@
+/**
+ * @file    Bosch_BME280_Compensation.cpp
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Deferred and single precision compensation of raw BME280 samples
+ */
+#include <Bosch_BME280_Compensation.h>
+
+int8_t BME::compensateSamples(const struct bme280_uncomp_data *raw, struct bme280_data *data, uint16_t count,
+                              const struct bme280_calib_data &calib, uint8_t sensor_comp) {
+  if (raw == nullptr || data == nullptr) {
+    return BME280_E_NULL_PTR;
+  }
+#ifdef BME280_FLOAT_ENABLE
+  // the single precision kernels of the getters, like bme280_compensate_data() the temperature is always
+  // compensated and the quantities not selected are cleared
+  for (uint16_t i = 0; i < count; ++i) {
+    int32_t t_fine;
+    data[i].temperature = compensateTemperatureFloat(raw[i].temperature, calib, t_fine);
+    data[i].pressure = (sensor_comp & BME280_PRESS) ? compensatePressureFloat(raw[i].pressure, calib, t_fine) : 0.0;
+    data[i].humidity = (sensor_comp & BME280_HUM) ? compensateHumidityFloat(raw[i].humidity, calib, t_fine) : 0.0;
+  }
+  return BME280_OK;
+#else
+  // local copy: the Bosch API stores t_fine in the calibration data
+  struct bme280_calib_data calib_data = calib;
+  int8_t result {BME280_OK};
+  for (uint16_t i = 0; i < count && result == BME280_OK; ++i) {
+    result = bme280_compensate_data(sensor_comp, &raw[i], &data[i], &calib_data);
+  }
+  return result;
+#endif
+}
+
+float BME::compensateTemperatureFloat(uint32_t adc_t, const struct bme280_calib_data &calib, int32_t &t_fine) {
+  // adc_t / 16384 - dig_t1 / 1024 = (adc_t - 16 * dig_t1) / 16384: the difference is calculated exactly as integer
+  float diff = (float)((int32_t)adc_t - ((int32_t)calib.dig_t1 << 4));
+  float var1 = diff / 16384.0F * (float)calib.dig_t2;
+  float var2 = diff / 131072.0F;
+  var2 = var2 * var2 * (float)calib.dig_t3;
+  t_fine = (int32_t)(var1 + var2);
+  float temperature = (var1 + var2) / 5120.0F;
+  if (temperature < -40.0F) {
+    temperature = -40.0F;
+  }
+  else if (temperature > 85.0F) {
+    temperature = 85.0F;
+  }
+  return temperature;
+}
+
+float BME::compensatePressureFloat(uint32_t adc_p, const struct bme280_calib_data &calib, int32_t t_fine) {
+  float var1 = ((float)t_fine / 2.0F) - 64000.0F;
+  float var2 = var1 * var1 * (float)calib.dig_p6 / 32768.0F;
+  var2 = var2 + var1 * (float)calib.dig_p5 * 2.0F;
+  var2 = (var2 / 4.0F) + ((float)calib.dig_p4 * 65536.0F);
+  float var3 = (float)calib.dig_p3 * var1 * var1 / 524288.0F;
+  var1 = (var3 + (float)calib.dig_p2 * var1) / 524288.0F;
+  var1 = (1.0F + var1 / 32768.0F) * (float)calib.dig_p1;
+  // avoid division by zero
+  if (var1 <= 0.0F) {
+    return 30000.0F;
+  }
+  float pressure = 1048576.0F - (float)adc_p;
+  pressure = (pressure - (var2 / 4096.0F)) * 6250.0F / var1;
+  var1 = (float)calib.dig_p9 * pressure * pressure / 2147483648.0F;
+  var2 = pressure * (float)calib.dig_p8 / 32768.0F;
+  pressure = pressure + (var1 + var2 + (float)calib.dig_p7) / 16.0F;
+  if (pressure < 30000.0F) {
+    pressure = 30000.0F;
+  }
+  else if (pressure > 110000.0F) {
+    pressure = 110000.0F;
+  }
+  return pressure;
+}
+
+float BME::compensateHumidityFloat(uint32_t adc_h, const struct bme280_calib_data &calib, int32_t t_fine) {
+  float var1 = (float)t_fine - 76800.0F;
+  float var2 = (float)calib.dig_h4 * 64.0F + ((float)calib.dig_h5 / 16384.0F) * var1;
+  float var3 = (float)adc_h - var2;
+  float var4 = (float)calib.dig_h2 / 65536.0F;
+  float var5 = 1.0F + ((float)calib.dig_h3 / 67108864.0F) * var1;
+  float var6 = 1.0F + ((float)calib.dig_h6 / 67108864.0F) * var1 * var5;
+  var6 = var3 * var4 * (var5 * var6);
+  float humidity = var6 * (1.0F - (float)calib.dig_h1 * var6 / 524288.0F);
+  if (humidity > 100.0F) {
+    humidity = 100.0F;
+  }
+  else if (humidity < 0.0F) {
+    humidity = 0.0F;
+  }
+  return humidity;
+}
+
+void BME::compensateFloat(const struct bme280_uncomp_data &raw, const struct bme280_calib_data &calib,
+                          FloatData &data, uint8_t sensor_comp) {
+  int32_t t_fine;
+  data.temperature = compensateTemperatureFloat(raw.temperature, calib, t_fine);
+  if (sensor_comp & BME280_PRESS) {
+    data.pressure = compensatePressureFloat(raw.pressure, calib, t_fine);
+  }
+  if (sensor_comp & BME280_HUM) {
+    data.humidity = compensateHumidityFloat(raw.humidity, calib, t_fine);
+  }
+}
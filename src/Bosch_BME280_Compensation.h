@@ -0,0 +1,98 @@
+/**
+ * @file    Bosch_BME280_Compensation.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Deferred and single precision compensation of raw BME280 samples
+ */
+#ifndef _BOSCH_BME280_COMPENSATION_H_
+#define _BOSCH_BME280_COMPENSATION_H_
+#include <Arduino.h>
+#include "BME280_API/bme280.h"
+
+#if defined(BME280_FLOAT_ENABLE) && !defined(BME280_DOUBLE_ENABLE)
+#error "BME280_FLOAT_ENABLE can not be combined with BME280_32BIT_ENABLE or BME280_64BIT_ENABLE"
+#endif
+
+namespace BME {
+  /**
+   * @brief compensate an array of raw samples in one loop
+   * 
+   * Uses bme280_compensate_data() of the Bosch API, with BME280_FLOAT_ENABLE the single precision kernels,
+   * so the results are bit-identical to the getters of the wrapper in the selected compensation mode.
+   * 
+   * @param raw array of raw samples
+   * @param data array of compensated samples (same size as raw)
+   * @param count number of samples
+   * @param calib calibration data of the sensor which measured the samples
+   * @param sensor_comp BME280_PRESS, BME280_TEMP, BME280_HUM or BME280_ALL
+   * 
+   * @return sensor status
+   *
+   * @retval   0: Success
+   * @retval  <0: Fail
+   */
+  int8_t compensateSamples(const struct bme280_uncomp_data *raw, struct bme280_data *data, uint16_t count,
+                           const struct bme280_calib_data &calib, uint8_t sensor_comp = BME280_ALL);
+
+  /**
+   * @brief compensated values of the single precision compensation
+   * 
+   */
+  struct FloatData {
+    // temperature in degree celsius
+    float temperature;
+
+    // air pressure in pascal
+    float pressure;
+
+    // humidity in %
+    float humidity;
+  };
+
+  /**
+   * @brief single precision compensation of the temperature (float version of the datasheet formula)
+   * 
+   * @param adc_t raw temperature
+   * @param calib calibration data
+   * @param t_fine fine temperature for the pressure and humidity compensation (integer like the Bosch API)
+   * @return temperature in degree celsius (-40...85)
+   */
+  float compensateTemperatureFloat(uint32_t adc_t, const struct bme280_calib_data &calib, int32_t &t_fine);
+
+  /**
+   * @brief single precision compensation of the pressure
+   * 
+   * @param adc_p raw pressure
+   * @param calib calibration data
+   * @param t_fine fine temperature of compensateTemperatureFloat()
+   * @return air pressure in pascal (30000...110000)
+   */
+  float compensatePressureFloat(uint32_t adc_p, const struct bme280_calib_data &calib, int32_t t_fine);
+
+  /**
+   * @brief single precision compensation of the humidity
+   * 
+   * @param adc_h raw humidity
+   * @param calib calibration data
+   * @param t_fine fine temperature of compensateTemperatureFloat()
+   * @return humidity in % (0...100)
+   */
+  float compensateHumidityFloat(uint32_t adc_h, const struct bme280_calib_data &calib, int32_t t_fine);
+
+  /**
+   * @brief single precision compensation of a raw sample
+   * 
+   * Same formulas and limits as the double compensation of the Bosch API, in single precision.
+   * Faster on targets without double precision FPU (ESP32, ESP8266, AVR), independent of the
+   * compensation mode of the library. The wrapper uses it with the build flag BME280_FLOAT_ENABLE.
+   * 
+   * @param raw raw sample
+   * @param calib calibration data
+   * @param data compensated values, quantities not selected by sensor_comp are unchanged
+   * @param sensor_comp BME280_PRESS, BME280_TEMP, BME280_HUM or BME280_ALL (the temperature is always compensated)
+   */
+  void compensateFloat(const struct bme280_uncomp_data &raw, const struct bme280_calib_data &calib,
+                       FloatData &data, uint8_t sensor_comp = BME280_ALL);
+}
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @file    Bosch_BME280_ErrorLog.cpp
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Allocation free error log of the Bosch BME280 Arduino Wrapper Class
+ */
+#include <Bosch_BME280_Arduino.h>
+
+namespace {
+  // name of the function which reported the error
+  const __FlashStringHelper *sourceName(BME::ErrorSource source) {
+    switch (source) {
+      case BME::ERROR_BEGIN:
+        return F("begin");
+      case BME::ERROR_RESUME:
+        return F("resume");
+      case BME::ERROR_READ:
+        return F("bme280_get_regs");
+      case BME::ERROR_WRITE:
+        return F("bme280_set_regs");
+      case BME::ERROR_SYNCHRONIZE:
+        return F("synchronize");
+      case BME::ERROR_CONVERSION:
+        return F("waitForConversion");
+      default:
+        return F("unknown");
+    }
+  }
+}
+
+uint16_t BME::ErrorLog::print(Print &out) {
+  ErrorEntry entry;
+  uint16_t n {0};
+  while (drain(&entry, 1) == 1) {
+    printError(out, entry);
+    ++n;
+  }
+  return n;
+}
+
+void BME::printError(Print &out, const ErrorEntry &entry) {
+  out.print(entry.timestamp);
+  out.print(F(" ms\t"));
+  out.print(sourceName(entry.source));
+  out.print(F("\tError ["));
+  out.print(entry.code);
+  switch (entry.code)
+  {
+    case BME280_E_NULL_PTR:
+        out.print(F("] : Null pointer error.\n"));
+        out.print(F("\t\t=> It occurs when the user tries to assign value (not address) to a pointer, which has been initialized to NULL.\r\n\n"));
+        break;
+
+    case BME280_E_COMM_FAIL:
+        out.print(F("] : Communication failure error.\n"));
+        out.print(F("\t\t=> It occurs due to read/write operation failure and also due to power failure during communication\r\n\n"));
+        break;
+
+    case BME280_E_DEV_NOT_FOUND:
+        out.print(F("] : Device not found error.\n"));
+        out.print(F("\t\t=> It occurs when the device chip id is incorrectly read\r\n\n"));
+        break;
+
+    case E_MEAS_TIMEOUT:
+        out.print(F("] : Measurement timeout error.\n"));
+        out.print(F("\t\t=> It occurs when the status register reports a running conversion after the timeout\r\n\n"));
+        break;
+
+    case BME280_E_INVALID_LEN:
+        out.print(F("] : Invalid length error.\n"));
+        out.print(F("\t\t=> It occurs when write is done with invalid length\r\n\n"));
+        break;
+
+    default:
+        out.print(F("] : Unknown error code\r\n\n"));
+        break;
+  }
+}
@@ -0,0 +1,142 @@
+/**
+ * @file    Bosch_BME280_ErrorLog.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Allocation free error log of the Bosch BME280 Arduino Wrapper Class
+ *
+ * Errors are recorded in a small ring buffer with counters instead of being printed during the measurement.
+ * The size of the ring buffer is set with the build flag BME280_ERROR_LOG_SIZE (default 8 entries).
+ */
+#ifndef _BOSCH_BME280_ERRORLOG_H_
+#define _BOSCH_BME280_ERRORLOG_H_
+#include <Arduino.h>
+#include "Bosch_BME280_SampleBuffer.h"
+
+#ifndef BME280_ERROR_LOG_SIZE
+#define BME280_ERROR_LOG_SIZE 8
+#endif
+
+namespace BME {
+  /**
+   * @brief function which reported an error
+   *
+   */
+  enum ErrorSource : uint8_t {
+    ERROR_BEGIN,
+    ERROR_RESUME,
+    ERROR_READ,
+    ERROR_WRITE,
+    ERROR_SYNCHRONIZE,
+    ERROR_CONVERSION,
+    ERROR_SOURCE_COUNT
+  };
+
+  /**
+   * @brief entry of the error log (8 bytes)
+   *
+   */
+  struct ErrorEntry {
+    // time of the error in ms (millis())
+    uint32_t timestamp;
+
+    // function which reported the error
+    ErrorSource source;
+
+    // error code, e.g. BME280_E_COMM_FAIL or BME::E_MEAS_TIMEOUT
+    int8_t code;
+  };
+
+  /**
+   * @brief ring buffer of the last errors with a counter per source
+   *
+   * If the log is full the oldest entry is overwritten, the counters count all errors.
+   * On the ESP32 the log and the counters are locked, so the scheduler task may record while loop() reads.
+   */
+  class ErrorLog : public RingBuffer<ErrorEntry, BME280_ERROR_LOG_SIZE> {
+    public:
+      ErrorLog() : _counts {} {
+#ifdef ESP32
+        portMUX_INITIALIZE(&_mux);
+#endif
+      }
+
+      /**
+       * @brief record an error
+       *
+       * @param source function which reported the error
+       * @param code error code
+       * @return recorded entry
+       */
+      ErrorEntry record(ErrorSource source, int8_t code) {
+        ErrorEntry entry {(uint32_t) millis(), source, code};
+        BME280_CRITICAL_SECTION(_mux);
+        push(entry);
+        ++_counts[source];
+        return entry;
+      }
+
+      /**
+       * @brief Get the number of errors of a source since the last clear()
+       *
+       * @param source function which reported the errors
+       * @return number of errors
+       */
+      uint32_t count(ErrorSource source) const {
+        BME280_CRITICAL_SECTION(_mux);
+        return _counts[source];
+      }
+
+      /**
+       * @brief Get the number of errors of all sources since the last clear()
+       *
+       * @return number of errors
+       */
+      uint32_t total() const {
+        BME280_CRITICAL_SECTION(_mux);
+        uint32_t sum {0};
+        for (uint8_t i = 0; i < ERROR_SOURCE_COUNT; ++i) {
+          sum += _counts[i];
+        }
+        return sum;
+      }
+
+      /**
+       * @brief remove all entries and reset the counters
+       *
+       */
+      void clear() {
+        BME280_CRITICAL_SECTION(_mux);
+        RingBuffer<ErrorEntry, BME280_ERROR_LOG_SIZE>::clear();
+        memset(_counts, 0, sizeof(_counts));
+      }
+
+      /**
+       * @brief print and remove the stored entries, the oldest first
+       *
+       * Call it outside of the measurement, e.g. bme.getErrorLog().print(Serial);
+       *
+       * @param out output, e.g. Serial
+       * @return number of printed entries
+       */
+      uint16_t print(Print &out);
+
+    private:
+      // number of errors per source
+      uint32_t _counts[ERROR_SOURCE_COUNT];
+
+#ifdef ESP32
+      // lock of the counters, the entries are locked by the ring buffer
+      mutable portMUX_TYPE _mux;
+#endif
+  };
+
+  /**
+   * @brief print one error entry with the description of the error code
+   *
+   * @param out output, e.g. Serial
+   * @param entry error entry
+   */
+  void printError(Print &out, const ErrorEntry &entry);
+}
+#endif
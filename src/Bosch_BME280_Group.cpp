@@ -0,0 +1,80 @@
+/**
+ * @file    Bosch_BME280_Group.cpp
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Group of BME280 sensors which are measured concurrently
+ */
+#include <Bosch_BME280_Group.h>
+
+BME::SensorGroupBase::SensorGroupBase(Bosch_BME280 **sensors, uint8_t capacity) :
+  _sensors {sensors},
+  _capacity {capacity},
+  _count {0}
+{
+}
+
+bool BME::SensorGroupBase::add(Bosch_BME280 &sensor) {
+  if (_count >= _capacity) {
+    return false;
+  }
+  _sensors[_count++] = &sensor;
+  return true;
+}
+
+int8_t BME::SensorGroupBase::begin() {
+  int8_t result {BME280_OK};
+  for (uint8_t i = 0; i < _count; ++i) {
+    int8_t rslt = _sensors[i]->begin();
+    if (result == BME280_OK) {
+      result = rslt;
+    }
+  }
+  return result;
+}
+
+int8_t BME::SensorGroupBase::measure() {
+  int8_t result = startMeasurement();
+  // the conversions run in parallel: poll until the last one is read
+  while (!isReady()) {
+    int8_t rslt = poll();
+    if (result == BME280_OK) {
+      result = rslt;
+    }
+    yield();
+  }
+  return result;
+}
+
+int8_t BME::SensorGroupBase::startMeasurement() {
+  int8_t result {BME280_OK};
+  for (uint8_t i = 0; i < _count; ++i) {
+    int8_t rslt = _sensors[i]->startMeasurement();
+    if (result == BME280_OK) {
+      result = rslt;
+    }
+  }
+  return result;
+}
+
+int8_t BME::SensorGroupBase::poll() {
+  int8_t result {BME280_OK};
+  for (uint8_t i = 0; i < _count; ++i) {
+    if (_sensors[i]->isMeasuring()) {
+      int8_t rslt = _sensors[i]->poll();
+      if (result == BME280_OK) {
+        result = rslt;
+      }
+    }
+  }
+  return result;
+}
+
+bool BME::SensorGroupBase::isReady() const {
+  for (uint8_t i = 0; i < _count; ++i) {
+    if (_sensors[i]->isMeasuring()) {
+      return false;
+    }
+  }
+  return true;
+}
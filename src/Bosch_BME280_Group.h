@@ -0,0 +1,126 @@
+/**
+ * @file    Bosch_BME280_Group.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Group of BME280 sensors which are measured concurrently
+ */
+#ifndef _BOSCH_BME280_GROUP_H_
+#define _BOSCH_BME280_GROUP_H_
+#include <Arduino.h>
+#include "Bosch_BME280_Arduino.h"
+
+namespace BME {
+  /**
+   * @brief group of sensors on one or more I²C-Buses
+   * 
+   * The conversions of all sensors are triggered back to back, so a measurement of the group
+   * takes about one conversion time instead of one conversion time per sensor.
+   * Use SensorGroup<N> to get a group with its own storage.
+   */
+  class SensorGroupBase {
+    public:
+      /**
+       * @brief add a sensor to the group
+       * 
+       * @param sensor sensor object, it must exist as long as the group
+       * @return true if the sensor was added, false if the group is full
+       */
+      bool add(Bosch_BME280 &sensor);
+
+      /**
+       * @brief init all sensors of the group
+       * 
+       * @return status of the first failed sensor, 0 if all succeeded
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t begin();
+
+      /**
+       * @brief measure all sensors and wait once for the longest conversion time
+       * 
+       * @return status of the first failed sensor, 0 if all succeeded
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t measure();
+
+      /**
+       * @brief trigger the conversion of all sensors without waiting
+       * 
+       * @return status of the first failed sensor, 0 if all succeeded
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t startMeasurement();
+
+      /**
+       * @brief read the data of every sensor whose conversion time has elapsed, never waits
+       * 
+       * @return status of the first failed sensor, 0 if all succeeded
+       *
+       * @retval   0: Success
+       * @retval  >0: Warning
+       * @retval  <0: Fail
+       */
+      int8_t poll();
+
+      /**
+       * @brief check if no sensor of the group is measuring any more
+       * 
+       * @return true if the started measurement of the group is finished
+       */
+      bool isReady() const;
+
+      /**
+       * @brief Get the number of sensors in the group
+       * 
+       * @return number of sensors
+       */
+      uint8_t size() const {return _count;}
+
+      /**
+       * @brief access a sensor of the group
+       * 
+       * @param index index in the order of add()
+       * @return sensor object
+       */
+      Bosch_BME280 &operator[](uint8_t index) {return *_sensors[index];}
+
+    protected:
+      /**
+       * @brief Construct a new sensor group on the given storage
+       * 
+       * @param sensors array of sensor pointers
+       * @param capacity size of the array
+       */
+      SensorGroupBase(Bosch_BME280 **sensors, uint8_t capacity);
+
+    private:
+      // storage of the sensor pointers
+      Bosch_BME280 **_sensors;
+      uint8_t _capacity, _count;
+  };
+
+  /**
+   * @brief group of up to N sensors
+   * 
+   * @tparam N maximum number of sensors
+   */
+  template <uint8_t N>
+  class SensorGroup : public SensorGroupBase {
+    public:
+      SensorGroup() : SensorGroupBase(_sensor_list, N) {}
+
+    private:
+      Bosch_BME280 *_sensor_list[N];
+  };
+}
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file    Bosch_BME280_PackedSample.cpp
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Packed format of raw BME280 samples for storage and uplink
+ */
+#include <Bosch_BME280_PackedSample.h>
+
+namespace {
+  // bits 6-7 of a delta header are 0, a packed sample with one of them set is stored without header
+  const uint8_t HEADER_RESERVED {0xC0};
+
+  // header in front of a packed sample whose first byte has bits 6-7 clear (3 + 3 + 3 bytes are never a delta)
+  const uint8_t HEADER_ABSOLUTE {0x3F};
+
+  // zigzag encoding: small negative and positive deltas get small codes
+  uint32_t zigzagEncode(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+  }
+
+  int32_t zigzagDecode(uint32_t code) {
+    return (int32_t)(code >> 1) ^ -(int32_t)(code & 1);
+  }
+
+  // number of bytes (0...3) needed for a code, 4 if it does not fit
+  uint8_t codeLength(uint32_t code) {
+    uint8_t len {0};
+    while (code != 0) {
+      code >>= 8;
+      ++len;
+    }
+    return len;
+  }
+
+  uint8_t writeCode(uint32_t code, uint8_t len, uint8_t *buffer) {
+    for (uint8_t i = 0; i < len; ++i) {
+      buffer[i] = (uint8_t)(code >> (8 * i));
+    }
+    return len;
+  }
+
+  uint8_t readCode(const uint8_t *buffer, uint8_t len, uint32_t &code) {
+    code = 0;
+    for (uint8_t i = 0; i < len; ++i) {
+      code |= (uint32_t)buffer[i] << (8 * i);
+    }
+    return len;
+  }
+}
+
+void BME::packSample(const struct bme280_uncomp_data &raw, uint8_t *buffer) {
+  buffer[0] = (uint8_t)(raw.pressure >> 12);
+  buffer[1] = (uint8_t)(raw.pressure >> 4);
+  buffer[2] = (uint8_t)(((raw.pressure & 0x0F) << 4) | ((raw.temperature >> 16) & 0x0F));
+  buffer[3] = (uint8_t)(raw.temperature >> 8);
+  buffer[4] = (uint8_t)raw.temperature;
+  buffer[5] = (uint8_t)(raw.humidity >> 8);
+  buffer[6] = (uint8_t)raw.humidity;
+}
+
+void BME::unpackSample(const uint8_t *buffer, struct bme280_uncomp_data &raw) {
+  raw.pressure = ((uint32_t)buffer[0] << 12) | ((uint32_t)buffer[1] << 4) | ((uint32_t)buffer[2] >> 4);
+  raw.temperature = ((uint32_t)(buffer[2] & 0x0F) << 16) | ((uint32_t)buffer[3] << 8) | (uint32_t)buffer[4];
+  raw.humidity = ((uint32_t)buffer[5] << 8) | (uint32_t)buffer[6];
+}
+
+uint8_t BME::packSampleDelta(const struct bme280_uncomp_data &raw, const struct bme280_uncomp_data &previous, uint8_t *buffer) {
+  uint32_t code_p = zigzagEncode((int32_t)raw.pressure - (int32_t)previous.pressure);
+  uint32_t code_t = zigzagEncode((int32_t)raw.temperature - (int32_t)previous.temperature);
+  uint32_t code_h = zigzagEncode((int32_t)raw.humidity - (int32_t)previous.humidity);
+  uint8_t len_p = codeLength(code_p);
+  uint8_t len_t = codeLength(code_t);
+  uint8_t len_h = codeLength(code_h);
+
+  // the packed sample is stored without header if its first byte can not be a delta header
+  bool plain = (raw.pressure >> 12) & HEADER_RESERVED;
+  uint8_t absolute_size = plain ? PACKED_SAMPLE_SIZE : PACKED_SAMPLE_SIZE + 1;
+  if (len_p > 3 || len_t > 3 || len_h > 3 || (1 + len_p + len_t + len_h) > absolute_size) {
+    // deltas are bigger than the sample itself
+    if (plain) {
+      packSample(raw, buffer);
+      return PACKED_SAMPLE_SIZE;
+    }
+    buffer[0] = HEADER_ABSOLUTE;
+    packSample(raw, &buffer[1]);
+    return PACKED_SAMPLE_SIZE + 1;
+  }
+  uint8_t pos {1};
+  buffer[0] = (uint8_t)(len_p | (len_t << 2) | (len_h << 4));
+  pos += writeCode(code_p, len_p, &buffer[pos]);
+  pos += writeCode(code_t, len_t, &buffer[pos]);
+  pos += writeCode(code_h, len_h, &buffer[pos]);
+  return pos;
+}
+
+uint8_t BME::unpackSampleDelta(const uint8_t *buffer, const struct bme280_uncomp_data &previous, struct bme280_uncomp_data &raw) {
+  if (buffer[0] & HEADER_RESERVED) {
+    unpackSample(buffer, raw);
+    return PACKED_SAMPLE_SIZE;
+  }
+  if (buffer[0] == HEADER_ABSOLUTE) {
+    unpackSample(&buffer[1], raw);
+    return PACKED_SAMPLE_SIZE + 1;
+  }
+  uint32_t code;
+  uint8_t pos {1};
+  pos += readCode(&buffer[pos], buffer[0] & 0x03, code);
+  raw.pressure = (uint32_t)((int32_t)previous.pressure + zigzagDecode(code));
+  pos += readCode(&buffer[pos], (buffer[0] >> 2) & 0x03, code);
+  raw.temperature = (uint32_t)((int32_t)previous.temperature + zigzagDecode(code));
+  pos += readCode(&buffer[pos], (buffer[0] >> 4) & 0x03, code);
+  raw.humidity = (uint32_t)((int32_t)previous.humidity + zigzagDecode(code));
+  return pos;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file    Bosch_BME280_PackedSample.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Packed format of raw BME280 samples for storage and uplink
+ */
+#ifndef _BOSCH_BME280_PACKEDSAMPLE_H_
+#define _BOSCH_BME280_PACKEDSAMPLE_H_
+#include <Arduino.h>
+#include "BME280_API/bme280.h"
+
+namespace BME {
+  /**
+   * @brief size of a packed raw sample in bytes (20 bit pressure, 20 bit temperature, 16 bit humidity)
+   * 
+   */
+  const uint8_t PACKED_SAMPLE_SIZE {7};
+
+  /**
+   * @brief maximum size of a delta encoded sample in bytes
+   * 
+   * In the operating range of the sensor a delta encoded sample has at most PACKED_SAMPLE_SIZE bytes,
+   * only raw pressures below 0x40000 (above 1100 hPa) need a header in front of the packed sample.
+   */
+  const uint8_t PACKED_DELTA_MAX_SIZE {PACKED_SAMPLE_SIZE + 1};
+
+  /**
+   * @brief pack the raw ADC values of a sample into 7 bytes
+   * 
+   * The raw values together with the calibration data of the sensor reproduce the
+   * compensated values exactly, so no precision is lost.
+   * 
+   * @param raw raw data (e.g. Bosch_BME280::getRawData())
+   * @param buffer destination, PACKED_SAMPLE_SIZE bytes
+   */
+  void packSample(const struct bme280_uncomp_data &raw, uint8_t *buffer);
+
+  /**
+   * @brief unpack a sample packed by packSample()
+   * 
+   * @param buffer source, PACKED_SAMPLE_SIZE bytes
+   * @param raw raw data
+   */
+  void unpackSample(const uint8_t *buffer, struct bme280_uncomp_data &raw);
+
+  /**
+   * @brief encode a sample as delta to the previous sample
+   * 
+   * The first byte is a header with the byte count of each zigzag encoded delta (bits 0-1: pressure,
+   * bits 2-3: temperature, bits 4-5: humidity, bits 6-7: 0). If the deltas are not smaller than the sample,
+   * the sample is stored as plain packed sample of PACKED_SAMPLE_SIZE bytes: its first byte holds the upper
+   * bits of the raw pressure and has bit 6 or 7 set for raw pressures from 0x40000. Smaller raw pressures
+   * (above 1100 hPa) are stored after the header 0x3F, which is no delta header (3 + 3 + 3 bytes).
+   * For the first sample of a stream use a zero previous sample.
+   * 
+   * @param raw raw data of the sample
+   * @param previous raw data of the previous sample of the stream
+   * @param buffer destination, up to PACKED_DELTA_MAX_SIZE bytes
+   * @return number of bytes written
+   */
+  uint8_t packSampleDelta(const struct bme280_uncomp_data &raw, const struct bme280_uncomp_data &previous, uint8_t *buffer);
+
+  /**
+   * @brief decode a sample encoded by packSampleDelta()
+   * 
+   * @param buffer source
+   * @param previous raw data of the previous sample of the stream
+   * @param raw raw data of the sample
+   * @return number of bytes read
+   */
+  uint8_t unpackSampleDelta(const uint8_t *buffer, const struct bme280_uncomp_data &previous, struct bme280_uncomp_data &raw);
+}
+#endif
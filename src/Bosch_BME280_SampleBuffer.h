@@ -0,0 +1,237 @@
+/**
+ * @file    Bosch_BME280_SampleBuffer.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Allocation free ring buffers of BME280 samples
+ */
+#ifndef _BOSCH_BME280_SAMPLEBUFFER_H_
+#define _BOSCH_BME280_SAMPLEBUFFER_H_
+#include <Arduino.h>
+#include "BME280_API/bme280.h"
+
+namespace BME {
+  /**
+   * @brief compact timestamped sample record (12 bytes)
+   * 
+   */
+  struct SampleRecord {
+    /**
+     * @brief time of the measurement in ms (millis())
+     * 
+     */
+    uint32_t timestamp;
+
+    /**
+     * @brief air pressure in 1/100 pascal
+     * 
+     */
+    uint32_t pressure;
+
+    /**
+     * @brief temperature in 1/100 degree celsius
+     * 
+     */
+    int16_t temperature;
+
+    /**
+     * @brief humidity in 1/100 %
+     * 
+     */
+    uint16_t humidity;
+  };
+
+#ifdef ESP32
+  /**
+   * @brief scoped critical section of data shared with the esp_timer task (ESP32 only)
+   * 
+   * The spinlock is recursive on the same core, so nested sections are allowed.
+   * Use BME280_CRITICAL_SECTION(mux), it is empty on targets without tasks.
+   */
+  class CriticalSection {
+    public:
+      explicit CriticalSection(portMUX_TYPE &mux) : _mux {&mux} {portENTER_CRITICAL(_mux);}
+      ~CriticalSection() {portEXIT_CRITICAL(_mux);}
+      CriticalSection(const CriticalSection &) = delete;
+      CriticalSection &operator=(const CriticalSection &) = delete;
+
+    private:
+      portMUX_TYPE *_mux;
+  };
+#define BME280_CRITICAL_SECTION(mux) BME::CriticalSection critical_section {mux}
+#else
+#define BME280_CRITICAL_SECTION(mux)
+#endif
+
+  /**
+   * @brief ring buffer of records on storage provided by the derived class
+   * 
+   * If the buffer is full the oldest record is overwritten and counted as overrun.
+   * Use RingBuffer<T, N> to get a buffer with its own storage.
+   * On the ESP32 push(), drain() and clear() are locked, so the scheduler task may push while loop() drains.
+   * 
+   * @tparam T record type
+   */
+  template <class T>
+  class RingBufferBase {
+    public:
+      /**
+       * @brief append a record, if the buffer is full the oldest record is overwritten
+       * 
+       * @param record record
+       */
+      void push(const T &record) {
+        BME280_CRITICAL_SECTION(_mux);
+        if (_capacity == 0) {
+          ++_overruns;
+          return;
+        }
+        uint16_t head = (uint16_t)((_tail + _count) % _capacity);
+        _storage[head] = record;
+        if (_count < _capacity) {
+          ++_count;
+        }
+        else {
+          // buffer full: the oldest record was overwritten
+          _tail = (uint16_t)((_tail + 1) % _capacity);
+          ++_overruns;
+        }
+      }
+
+      /**
+       * @brief move the oldest records into the given array
+       * 
+       * @param records destination array
+       * @param max_count size of the destination array
+       * @return number of records copied
+       */
+      uint16_t drain(T *records, uint16_t max_count) {
+        BME280_CRITICAL_SECTION(_mux);
+        uint16_t n = (max_count < _count) ? max_count : _count;
+        if (n == 0) {
+          return 0;
+        }
+        // copy in at most two blocks: from the tail to the end of the storage and from the start
+        uint16_t first = _capacity - _tail;
+        if (first > n) {
+          first = n;
+        }
+        memcpy(records, &_storage[_tail], first * sizeof(T));
+        memcpy(records + first, _storage, (n - first) * sizeof(T));
+        _tail = (uint16_t)((_tail + n) % _capacity);
+        _count -= n;
+        return n;
+      }
+
+      /**
+       * @brief remove all records and reset the overrun counter
+       * 
+       */
+      void clear() {
+        BME280_CRITICAL_SECTION(_mux);
+        _tail = 0;
+        _count = 0;
+        _overruns = 0;
+      }
+
+      /**
+       * @brief Get the number of stored records
+       * 
+       * @return number of records
+       */
+      uint16_t size() const {return _count;}
+
+      /**
+       * @brief Get the capacity of the buffer
+       * 
+       * @return maximum number of records
+       */
+      uint16_t capacity() const {return _capacity;}
+
+      /**
+       * @brief Get the number of records lost because the buffer was full
+       * 
+       * @return number of overwritten records
+       */
+      uint32_t overruns() const {return _overruns;}
+
+    protected:
+      /**
+       * @brief Construct a new ring buffer on the given storage
+       * 
+       * @param storage array of records
+       * @param capacity number of records of the array
+       */
+      RingBufferBase(T *storage, uint16_t capacity) :
+        _storage {storage},
+        _capacity {capacity},
+        _tail {0},
+        _count {0},
+        _overruns {0}
+      {
+#ifdef ESP32
+        portMUX_INITIALIZE(&_mux);
+#endif
+      }
+
+    private:
+      // storage and capacity of the ring buffer
+      T *_storage;
+      uint16_t _capacity;
+
+      // index of the oldest record and number of records
+      uint16_t _tail, _count;
+
+      // number of overwritten records
+      uint32_t _overruns;
+
+#ifdef ESP32
+      // lock of the buffer state
+      portMUX_TYPE _mux;
+#endif
+  };
+
+  /**
+   * @brief ring buffer with storage for N records
+   * 
+   * @tparam T record type
+   * @tparam N capacity in records
+   */
+  template <class T, uint16_t N>
+  class RingBuffer : public RingBufferBase<T> {
+    public:
+      RingBuffer() : RingBufferBase<T>(_records, N) {}
+
+    private:
+      T _records[N];
+  };
+
+  /**
+   * @brief ring buffer of timestamped sample records
+   * 
+   */
+  typedef RingBufferBase<SampleRecord> SampleBufferBase;
+
+  /**
+   * @brief ring buffer with storage for N timestamped sample records
+   * 
+   * @tparam N capacity in records
+   */
+  template <uint16_t N>
+  using SampleBuffer = RingBuffer<SampleRecord, N>;
+
+  /**
+   * @brief ring buffer of raw (uncompensated) samples
+   * 
+   */
+  typedef RingBufferBase<struct bme280_uncomp_data> RawSampleBufferBase;
+
+  /**
+   * @brief ring buffer with storage for N raw (uncompensated) samples
+   * 
+   * @tparam N capacity in samples
+   */
+  template <uint16_t N>
+  using RawSampleBuffer = RingBuffer<struct bme280_uncomp_data, N>;
+}
+#endif
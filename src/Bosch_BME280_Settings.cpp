@@ -0,0 +1,58 @@
+/**
+ * @file    Bosch_BME280_Settings.cpp
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Typed sensor settings and the recommended modes of operation of the datasheet
+ */
+#include <Bosch_BME280_Arduino.h>
+
+namespace {
+  // typical current in µA during the measurement of temperature, pressure and humidity
+  const float CURRENT_TEMPERATURE {350.0F};
+  const float CURRENT_PRESSURE {714.0F};
+  const float CURRENT_HUMIDITY {340.0F};
+
+  // typical current in µA in sleep mode and in the standby time of the normal mode
+  const float CURRENT_SLEEP {0.1F};
+  const float CURRENT_STANDBY {0.2F};
+
+  // RMS noise of the pressure in Pa for oversampling 1x, 2x, 4x, 8x and 16x
+  const float PRESSURE_NOISE[] {3.3F, 2.6F, 2.1F, 1.6F, 1.3F};
+}
+
+BME::SettingsReport BME::evaluateSettings(const Settings &settings, bool forced_mode, uint32_t interval_ms) {
+  SettingsReport report;
+  report.measurement_time = typicalMeasurementTime(settings.osr_t, settings.osr_p, settings.osr_h);
+
+  // charge of one measurement in µA * ms: the start phase is counted with the temperature current
+  float charge = CURRENT_TEMPERATURE * (1.0F + 2.0F * oversamplingFactor(settings.osr_t));
+  if (settings.osr_p != OSR_SKIP) {
+    charge += CURRENT_PRESSURE * (2.0F * oversamplingFactor(settings.osr_p) + 0.5F);
+  }
+  if (settings.osr_h != OSR_SKIP) {
+    charge += CURRENT_HUMIDITY * (2.0F * oversamplingFactor(settings.osr_h) + 0.5F);
+  }
+
+  if (forced_mode) {
+    report.data_rate = 1000.0F / interval_ms;
+    report.current = charge * report.data_rate / 1000.0F + CURRENT_SLEEP;
+  }
+  else {
+    uint32_t period = report.measurement_time + standbyTime(settings.standby);
+    report.data_rate = 1000000.0F / period;
+    report.current = charge * report.data_rate / 1000.0F + CURRENT_STANDBY;
+  }
+
+  if (settings.osr_p == OSR_SKIP) {
+    report.noise = 0.0F;
+  }
+  else {
+    report.noise = PRESSURE_NOISE[settings.osr_p - OSR_1X];
+    if (settings.filter != FILTER_OFF) {
+      float coefficient = (float)(1U << settings.filter);
+      report.noise *= sqrt(1.0F / (2.0F * coefficient - 1.0F));
+    }
+  }
+  return report;
+}
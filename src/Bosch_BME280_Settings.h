@@ -0,0 +1,124 @@
+/**
+ * @file    Bosch_BME280_Settings.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Typed sensor settings and the recommended modes of operation of the datasheet
+ */
+#ifndef _BOSCH_BME280_SETTINGS_H_
+#define _BOSCH_BME280_SETTINGS_H_
+#include <Arduino.h>
+#include "BME280_API/bme280.h"
+
+namespace BME {
+  /**
+   * @brief oversampling setting of a measurement (register value)
+   *
+   */
+  enum Oversampling : uint8_t {
+    OSR_SKIP = BME280_NO_OVERSAMPLING,
+    OSR_1X = BME280_OVERSAMPLING_1X,
+    OSR_2X = BME280_OVERSAMPLING_2X,
+    OSR_4X = BME280_OVERSAMPLING_4X,
+    OSR_8X = BME280_OVERSAMPLING_8X,
+    OSR_16X = BME280_OVERSAMPLING_16X
+  };
+
+  /**
+   * @brief IIR filter coefficient (register value)
+   *
+   */
+  enum Filter : uint8_t {
+    FILTER_OFF = BME280_FILTER_COEFF_OFF,
+    FILTER_2 = BME280_FILTER_COEFF_2,
+    FILTER_4 = BME280_FILTER_COEFF_4,
+    FILTER_8 = BME280_FILTER_COEFF_8,
+    FILTER_16 = BME280_FILTER_COEFF_16
+  };
+
+  /**
+   * @brief standby time of the normal mode (register value)
+   *
+   */
+  enum Standby : uint8_t {
+    STANDBY_0_5_MS = BME280_STANDBY_TIME_0_5_MS,
+    STANDBY_10_MS = BME280_STANDBY_TIME_10_MS,
+    STANDBY_20_MS = BME280_STANDBY_TIME_20_MS,
+    STANDBY_62_5_MS = BME280_STANDBY_TIME_62_5_MS,
+    STANDBY_125_MS = BME280_STANDBY_TIME_125_MS,
+    STANDBY_250_MS = BME280_STANDBY_TIME_250_MS,
+    STANDBY_500_MS = BME280_STANDBY_TIME_500_MS,
+    STANDBY_1000_MS = BME280_STANDBY_TIME_1000_MS
+  };
+
+  /**
+   * @brief sensor settings
+   *
+   */
+  struct Settings {
+    Oversampling osr_p;
+    Oversampling osr_t;
+    Oversampling osr_h;
+    Filter filter;
+
+    // only used in normal mode
+    Standby standby;
+  };
+
+  /**
+   * @brief weather monitoring (datasheet 3.5.1), forced mode with 1 sample per minute
+   *
+   */
+  constexpr Settings PRESET_WEATHER_MONITORING {OSR_1X, OSR_1X, OSR_1X, FILTER_OFF, STANDBY_1000_MS};
+
+  /**
+   * @brief humidity sensing (datasheet 3.5.2), forced mode with 1 sample per second, no pressure
+   *
+   */
+  constexpr Settings PRESET_HUMIDITY_SENSING {OSR_SKIP, OSR_1X, OSR_1X, FILTER_OFF, STANDBY_1000_MS};
+
+  /**
+   * @brief indoor navigation (datasheet 3.5.3), normal mode with 25 Hz
+   *
+   */
+  constexpr Settings PRESET_INDOOR_NAVIGATION {OSR_16X, OSR_2X, OSR_1X, FILTER_16, STANDBY_0_5_MS};
+
+  /**
+   * @brief gaming (datasheet 3.5.4), normal mode with 83 Hz, no humidity
+   *
+   */
+  constexpr Settings PRESET_GAMING {OSR_4X, OSR_1X, OSR_SKIP, FILTER_16, STANDBY_0_5_MS};
+
+  /**
+   * @brief typical performance of settings, calculated with the datasheet values
+   *
+   */
+  struct SettingsReport {
+    // typical measurement time in µs
+    uint32_t measurement_time;
+
+    // output data rate in Hz
+    float data_rate;
+
+    // average current in µA
+    float current;
+
+    // RMS noise of the pressure in Pa (0 if the pressure is skipped)
+    float noise;
+  };
+
+  /**
+   * @brief calculate the typical output data rate, current and pressure noise of settings
+   *
+   * Current: 350 µA (temperature), 714 µA (pressure), 340 µA (humidity) during the measurement,
+   * 0.1 µA in sleep and 0.2 µA in standby. Noise: pressure noise of the oversampling, reduced by
+   * the IIR filter by sqrt(1 / (2 * coefficient - 1)).
+   *
+   * @param settings sensor settings
+   * @param forced_mode true for forced mode, false for normal mode
+   * @param interval_ms time between two measurements in forced mode in ms
+   * @return report
+   */
+  SettingsReport evaluateSettings(const Settings &settings, bool forced_mode, uint32_t interval_ms = 1000);
+}
+#endif
@@ -0,0 +1,318 @@
+/**
+ * @file    Bosch_BME280_Simulator.cpp
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Register level simulation of a BME280 as bus transport
+ */
+#include <Bosch_BME280_Simulator.h>
+
+constexpr enum bme280_intf BME::SimulatedBME280::intf;
+
+namespace {
+  // calibration data of the Bosch datasheet example (humidity: typical values)
+  const struct bme280_calib_data default_calib {27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000, 75, 362, 0, 313, 50, 30, 0};
+
+  // standby time in µs of the config register setting
+  const uint32_t standby_time_us[] {500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000};
+
+  // raw value of a skipped measurement
+  const uint32_t SKIPPED_20_BIT {0x80000};
+  const uint32_t SKIPPED_16_BIT {0x8000};
+
+  // compensation formulas of the datasheet (floating point) without range limits
+  double compensateTemperature(uint32_t adc_t, const struct bme280_calib_data &c, double &t_fine) {
+    double var1 = ((double)adc_t / 16384.0 - (double)c.dig_t1 / 1024.0) * (double)c.dig_t2;
+    double var2 = (double)adc_t / 131072.0 - (double)c.dig_t1 / 8192.0;
+    var2 = var2 * var2 * (double)c.dig_t3;
+    t_fine = var1 + var2;
+    return t_fine / 5120.0;
+  }
+
+  double compensatePressure(uint32_t adc_p, const struct bme280_calib_data &c, double t_fine) {
+    double var1 = (t_fine / 2.0) - 64000.0;
+    double var2 = var1 * var1 * (double)c.dig_p6 / 32768.0;
+    var2 = var2 + var1 * (double)c.dig_p5 * 2.0;
+    var2 = (var2 / 4.0) + ((double)c.dig_p4 * 65536.0);
+    var1 = ((double)c.dig_p3 * var1 * var1 / 524288.0 + (double)c.dig_p2 * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * (double)c.dig_p1;
+    if (var1 <= 0.0) {
+      return 0.0;
+    }
+    double p = 1048576.0 - (double)adc_p;
+    p = (p - (var2 / 4096.0)) * 6250.0 / var1;
+    var1 = (double)c.dig_p9 * p * p / 2147483648.0;
+    var2 = p * (double)c.dig_p8 / 32768.0;
+    return p + (var1 + var2 + (double)c.dig_p7) / 16.0;
+  }
+
+  double compensateHumidity(uint32_t adc_h, const struct bme280_calib_data &c, double t_fine) {
+    double var1 = t_fine - 76800.0;
+    double var2 = (double)c.dig_h4 * 64.0 + ((double)c.dig_h5 / 16384.0) * var1;
+    double var3 = (double)adc_h - var2;
+    double var4 = (double)c.dig_h2 / 65536.0;
+    double var5 = 1.0 + ((double)c.dig_h3 / 67108864.0) * var1;
+    double var6 = 1.0 + ((double)c.dig_h6 / 67108864.0) * var1 * var5;
+    var6 = var3 * var4 * (var5 * var6);
+    return var6 * (1.0 - (double)c.dig_h1 * var6 / 524288.0);
+  }
+
+  // binary search of the raw value (temperature and humidity rise, pressure falls with the raw value)
+  uint32_t findTemperatureRaw(double target, const struct bme280_calib_data &c) {
+    uint32_t lo {0}, hi {0xFFFFF};
+    double t_fine;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (compensateTemperature(mid, c, t_fine) < target) {
+        lo = mid + 1;
+      }
+      else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  uint32_t findPressureRaw(double target, const struct bme280_calib_data &c, double t_fine) {
+    uint32_t lo {0}, hi {0xFFFFF};
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (compensatePressure(mid, c, t_fine) > target) {
+        lo = mid + 1;
+      }
+      else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+  uint32_t findHumidityRaw(double target, const struct bme280_calib_data &c, double t_fine) {
+    uint32_t lo {0}, hi {0xFFFF};
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (compensateHumidity(mid, c, t_fine) < target) {
+        lo = mid + 1;
+      }
+      else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+}
+
+BME::SimulatedBME280::SimulatedBME280() :
+  _calib (default_calib),
+  _environment {20.0F, 101325.0F, 50.0F},
+  _model {nullptr},
+  _osr_h {0},
+  _conversion_start {0},
+  _converting {false},
+  _filter_p {0.0F},
+  _filter_t {0.0F},
+  _filter_valid {false},
+  _counters {0, 0, 0, 0, 0},
+  _fail {false}
+{
+  memset(_registers, 0, sizeof(_registers));
+  _registers[BME280_REG_CHIP_ID] = BME280_CHIP_ID;
+  setCalibData(default_calib);
+  reset();
+}
+
+int8_t BME::SimulatedBME280::begin() {
+  reset();
+  return BME280_OK;
+}
+
+void BME::SimulatedBME280::setCalibData(const struct bme280_calib_data &calib) {
+  _calib = calib;
+  const uint16_t words[12] {calib.dig_t1, (uint16_t)calib.dig_t2, (uint16_t)calib.dig_t3,
+                            calib.dig_p1, (uint16_t)calib.dig_p2, (uint16_t)calib.dig_p3,
+                            (uint16_t)calib.dig_p4, (uint16_t)calib.dig_p5, (uint16_t)calib.dig_p6,
+                            (uint16_t)calib.dig_p7, (uint16_t)calib.dig_p8, (uint16_t)calib.dig_p9};
+  for (uint8_t i = 0; i < 12; ++i) {
+    _registers[BME280_REG_TEMP_PRESS_CALIB_DATA + 2 * i] = (uint8_t)words[i];
+    _registers[BME280_REG_TEMP_PRESS_CALIB_DATA + 2 * i + 1] = (uint8_t)(words[i] >> 8);
+  }
+  _registers[0xA1] = calib.dig_h1;
+  _registers[BME280_REG_HUMIDITY_CALIB_DATA] = (uint8_t)calib.dig_h2;
+  _registers[BME280_REG_HUMIDITY_CALIB_DATA + 1] = (uint8_t)((uint16_t)calib.dig_h2 >> 8);
+  _registers[BME280_REG_HUMIDITY_CALIB_DATA + 2] = calib.dig_h3;
+  // dig_h4 and dig_h5 are 12 bit values sharing register 0xE5
+  _registers[BME280_REG_HUMIDITY_CALIB_DATA + 3] = (uint8_t)(calib.dig_h4 >> 4);
+  _registers[BME280_REG_HUMIDITY_CALIB_DATA + 4] = (uint8_t)((calib.dig_h4 & 0x0F) | ((calib.dig_h5 & 0x0F) << 4));
+  _registers[BME280_REG_HUMIDITY_CALIB_DATA + 5] = (uint8_t)(calib.dig_h5 >> 4);
+  _registers[BME280_REG_HUMIDITY_CALIB_DATA + 6] = (uint8_t)calib.dig_h6;
+}
+
+void BME::SimulatedBME280::resetCounters() {
+  _counters = SimulatorCounters {0, 0, 0, 0, 0};
+}
+
+int8_t BME::SimulatedBME280::read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len) {
+  ++_counters.reads;
+  _counters.read_bytes += len;
+  if (_fail) {
+    return BME280_E_COMM_FAIL;
+  }
+  update();
+  // all registers are located above 0x80, this also covers the SPI addressing
+  reg_addr |= 0x80;
+  for (uint32_t i = 0; i < len; i++) {
+    reg_data[i] = _registers[(uint8_t)(reg_addr + i)];
+  }
+  return BME280_OK;
+}
+
+int8_t BME::SimulatedBME280::write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len) {
+  ++_counters.writes;
+  _counters.write_bytes += len;
+  if (_fail) {
+    return BME280_E_COMM_FAIL;
+  }
+  update();
+  // burst write: data, address, data, address, data...
+  writeRegister(reg_addr | 0x80, reg_data[0]);
+  for (uint32_t i = 1; i + 1 < len; i += 2) {
+    writeRegister(reg_data[i] | 0x80, reg_data[i + 1]);
+  }
+  return BME280_OK;
+}
+
+uint32_t BME::SimulatedBME280::getConversionTime() const {
+  // typical measurement time of the datasheet
+  uint8_t ctrl_meas = _registers[BME280_REG_CTRL_MEAS];
+  uint32_t osr_t = BME280_GET_BITS(ctrl_meas, BME280_CTRL_TEMP);
+  uint32_t osr_p = BME280_GET_BITS(ctrl_meas, BME280_CTRL_PRESS);
+  uint32_t time_us {1000};
+  time_us += (osr_t != 0) ? 2000UL << (osr_t - 1) : 0;
+  time_us += (osr_p != 0) ? (2000UL << (osr_p - 1)) + 500 : 0;
+  time_us += (_osr_h != 0) ? (2000UL << (_osr_h - 1)) + 500 : 0;
+  return time_us;
+}
+
+void BME::SimulatedBME280::reset() {
+  _registers[BME280_REG_CTRL_HUM] = 0;
+  _registers[BME280_REG_STATUS] = 0;
+  _registers[BME280_REG_CTRL_MEAS] = 0;
+  _registers[BME280_REG_CONFIG] = 0;
+  // data registers hold the values of skipped measurements
+  _registers[BME280_REG_DATA] = 0x80;
+  _registers[BME280_REG_DATA + 1] = 0;
+  _registers[BME280_REG_DATA + 2] = 0;
+  _registers[BME280_REG_DATA + 3] = 0x80;
+  _registers[BME280_REG_DATA + 4] = 0;
+  _registers[BME280_REG_DATA + 5] = 0;
+  _registers[BME280_REG_DATA + 6] = 0x80;
+  _registers[BME280_REG_DATA + 7] = 0;
+  _osr_h = 0;
+  _converting = false;
+  _filter_valid = false;
+}
+
+void BME::SimulatedBME280::writeRegister(uint8_t reg_addr, uint8_t value) {
+  switch (reg_addr) {
+    case BME280_REG_RESET:
+      if (value == BME280_SOFT_RESET_COMMAND) {
+        reset();
+      }
+      break;
+
+    case BME280_REG_CTRL_HUM:
+      _registers[reg_addr] = value & BME280_CTRL_HUM_MSK;
+      break;
+
+    case BME280_REG_CTRL_MEAS:
+      _registers[reg_addr] = value;
+      // ctrl_hum becomes effective with the write of ctrl_meas
+      _osr_h = _registers[BME280_REG_CTRL_HUM];
+      _converting = (value & BME280_SENSOR_MODE_MSK) != BME280_POWERMODE_SLEEP;
+      _conversion_start = micros();
+      break;
+
+    case BME280_REG_CONFIG:
+      // writes to config in normal mode may be ignored by the sensor
+      if ((_registers[BME280_REG_CTRL_MEAS] & BME280_SENSOR_MODE_MSK) != BME280_POWERMODE_NORMAL) {
+        _registers[reg_addr] = value & 0xFD;
+      }
+      break;
+
+    default:
+      // read only register
+      break;
+  }
+}
+
+void BME::SimulatedBME280::update() {
+  uint8_t mode = _registers[BME280_REG_CTRL_MEAS] & BME280_SENSOR_MODE_MSK;
+  if (_converting) {
+    int32_t conversion_time = getConversionTime();
+    // negative in normal mode during the standby time before the next conversion
+    int32_t elapsed = (int32_t)(micros() - _conversion_start);
+    if (mode == BME280_POWERMODE_NORMAL) {
+      int32_t period = conversion_time + standby_time_us[BME280_GET_BITS(_registers[BME280_REG_CONFIG], BME280_STANDBY)];
+      if (elapsed >= conversion_time) {
+        // skip the conversions which were not observed, only the last one sets the data registers
+        uint32_t cycles = (elapsed - conversion_time) / period;
+        _counters.conversions += cycles;
+        _conversion_start += cycles * period;
+        convert();
+        _conversion_start += period;
+        elapsed = (int32_t)(micros() - _conversion_start);
+      }
+    }
+    else if (elapsed >= conversion_time) {
+      // forced mode: back to sleep after the conversion
+      convert();
+      _registers[BME280_REG_CTRL_MEAS] &= ~BME280_SENSOR_MODE_MSK;
+      _converting = false;
+    }
+    bool measuring = _converting && (elapsed >= 0) && (elapsed < conversion_time);
+    _registers[BME280_REG_STATUS] = measuring ? BME280_STATUS_MEAS_DONE : 0;
+  }
+  else {
+    _registers[BME280_REG_STATUS] = 0;
+  }
+}
+
+void BME::SimulatedBME280::convert() {
+  ++_counters.conversions;
+  Environment env = (_model != nullptr) ? _model(millis()) : _environment;
+  uint8_t ctrl_meas = _registers[BME280_REG_CTRL_MEAS];
+  uint8_t osr_t = BME280_GET_BITS(ctrl_meas, BME280_CTRL_TEMP);
+  uint8_t osr_p = BME280_GET_BITS(ctrl_meas, BME280_CTRL_PRESS);
+
+  double t_fine;
+  uint32_t adc_t = findTemperatureRaw(env.temperature, _calib);
+  compensateTemperature(adc_t, _calib, t_fine);
+  uint32_t adc_p = findPressureRaw(env.pressure, _calib, t_fine);
+  uint32_t adc_h = findHumidityRaw(env.humidity, _calib, t_fine);
+
+  // IIR filter of pressure and temperature
+  uint8_t filter = BME280_GET_BITS(_registers[BME280_REG_CONFIG], BME280_FILTER);
+  if (filter != BME280_FILTER_COEFF_OFF && _filter_valid) {
+    float coeff = (float)(1U << filter);
+    _filter_p = (_filter_p * (coeff - 1.0F) + (float)adc_p) / coeff;
+    _filter_t = (_filter_t * (coeff - 1.0F) + (float)adc_t) / coeff;
+  }
+  else {
+    _filter_p = (float)adc_p;
+    _filter_t = (float)adc_t;
+  }
+  _filter_valid = true;
+  adc_p = (osr_p != 0) ? (uint32_t)(_filter_p + 0.5F) : SKIPPED_20_BIT;
+  adc_t = (osr_t != 0) ? (uint32_t)(_filter_t + 0.5F) : SKIPPED_20_BIT;
+  adc_h = (_osr_h != 0) ? adc_h : SKIPPED_16_BIT;
+
+  uint8_t *data = &_registers[BME280_REG_DATA];
+  data[0] = (uint8_t)(adc_p >> 12);
+  data[1] = (uint8_t)(adc_p >> 4);
+  data[2] = (uint8_t)((adc_p & 0x0F) << 4);
+  data[3] = (uint8_t)(adc_t >> 12);
+  data[4] = (uint8_t)(adc_t >> 4);
+  data[5] = (uint8_t)((adc_t & 0x0F) << 4);
+  data[6] = (uint8_t)(adc_h >> 8);
+  data[7] = (uint8_t)adc_h;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file    Bosch_BME280_Simulator.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Register level simulation of a BME280 as bus transport
+ */
+#ifndef _BOSCH_BME280_SIMULATOR_H_
+#define _BOSCH_BME280_SIMULATOR_H_
+#include <Arduino.h>
+#include "BME280_API/bme280.h"
+
+namespace BME {
+  /**
+   * @brief environment conditions of the simulated sensor
+   * 
+   */
+  struct Environment {
+    /**
+     * @brief temperature in degree celsius
+     * 
+     */
+    float temperature;
+
+    /**
+     * @brief air pressure in pascal
+     * 
+     */
+    float pressure;
+
+    /**
+     * @brief humidity in %
+     * 
+     */
+    float humidity;
+  };
+
+  /**
+   * @brief bus counters of the simulated sensor
+   * 
+   */
+  struct SimulatorCounters {
+    // number of read and write transactions
+    uint32_t reads, writes;
+
+    // number of bytes transferred (without the register address of the transaction)
+    uint32_t read_bytes, write_bytes;
+
+    // number of finished conversions
+    uint32_t conversions;
+  };
+
+  /**
+   * @brief simulated BME280 which can be used as transport of a Bosch_BME280 object
+   * 
+   * Simulates chip id, calibration NVM, soft reset, ctrl_hum/ctrl_meas/config, the status register,
+   * forced and normal mode with the typical conversion time of the datasheet and the IIR filter.
+   * The data registers are the raw ADC values of an environment model, calculated by inverting
+   * the compensation formulas of the datasheet. The time base is micros().
+   */
+  class SimulatedBME280 {
+    public:
+      static constexpr enum bme280_intf intf {BME280_I2C_INTF};
+
+      /**
+       * @brief Construct a new simulated sensor with default calibration and 20 °C, 1013.25 hPa, 50 %
+       * 
+       */
+      SimulatedBME280();
+
+      /**
+       * @brief power on reset of the simulated sensor
+       * 
+       * @return BME280_OK
+       */
+      int8_t begin();
+
+      /**
+       * @brief read registers
+       * 
+       * @param reg_addr Register Address
+       * @param reg_data Register Data
+       * @param len count of Bytes
+       * 
+       * @return BME280_E_COMM_FAIL if a failure is injected, else BME280_OK
+       */
+      int8_t read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len);
+
+      /**
+       * @brief write registers (burst write with interleaved addresses)
+       * 
+       * @param reg_addr Register Address
+       * @param reg_data Register Data
+       * @param len count of Bytes
+       * 
+       * @return BME280_E_COMM_FAIL if a failure is injected, else BME280_OK
+       */
+      int8_t write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len);
+
+      /**
+       * @brief set constant environment conditions
+       * 
+       * @param environment temperature, pressure and humidity
+       */
+      void setEnvironment(const Environment &environment) {_environment = environment;}
+
+      /**
+       * @brief set a model which returns the environment conditions at a time
+       * 
+       * @param model function of the time in ms, nullptr for constant conditions
+       */
+      void setEnvironmentModel(Environment (*model)(uint32_t time_ms)) {_model = model;}
+
+      /**
+       * @brief set the calibration data written into the NVM registers
+       * 
+       * @param calib calibration data, e.g. of a real sensor
+       */
+      void setCalibData(const struct bme280_calib_data &calib);
+
+      /**
+       * @brief inject bus failures
+       * 
+       * @param fail if true all transactions fail with BME280_E_COMM_FAIL
+       */
+      void setFail(bool fail) {_fail = fail;}
+
+      /**
+       * @brief Get the bus counters
+       * 
+       * @return counters
+       */
+      const SimulatorCounters &getCounters() const {return _counters;}
+
+      /**
+       * @brief reset the bus counters
+       * 
+       */
+      void resetCounters();
+
+      /**
+       * @brief Get the typical conversion time of the current settings
+       * 
+       * @return conversion time in µs
+       */
+      uint32_t getConversionTime() const;
+
+    private:
+      // register map
+      uint8_t _registers[256];
+
+      // calibration data of the NVM registers
+      struct bme280_calib_data _calib;
+
+      // environment conditions
+      Environment _environment;
+      Environment (*_model)(uint32_t time_ms);
+
+      // active humidity oversampling (ctrl_hum is latched by a write to ctrl_meas)
+      uint8_t _osr_h;
+
+      // start of the running conversion in µs
+      uint32_t _conversion_start;
+      bool _converting;
+
+      // IIR filter state of pressure and temperature
+      float _filter_p, _filter_t;
+      bool _filter_valid;
+
+      SimulatorCounters _counters;
+      bool _fail;
+
+      void reset();
+      void writeRegister(uint8_t reg_addr, uint8_t value);
+      void update();
+      void convert();
+  };
+}
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file    Bosch_BME280_Stats.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Bus and latency statistics of the Bosch BME280 Arduino Wrapper Class
+ *
+ * The statistics are recorded only if the library is compiled with BME280_STATS_ENABLE,
+ * otherwise the recording functions are empty and the compiler removes them.
+ */
+#ifndef _BOSCH_BME280_STATS_H_
+#define _BOSCH_BME280_STATS_H_
+#include <Arduino.h>
+
+namespace BME {
+  /**
+   * @brief public API functions with own statistics
+   *
+   * Bus traffic of nested calls (e.g. startMeasurement() inside measure()) is counted for the outer call.
+   */
+  enum StatsApi : uint8_t {
+    STATS_BEGIN,
+    STATS_MEASURE,
+    STATS_START_MEASUREMENT,
+    STATS_POLL,
+    STATS_SERVICE,
+    STATS_OTHER,
+    STATS_API_COUNT
+  };
+
+  /**
+   * @brief bus statistics of one API function
+   *
+   */
+  struct ApiStats {
+    // number of calls of the API function
+    uint32_t calls;
+
+    // number of read and write transactions
+    uint32_t reads, writes;
+
+    // number of bytes transferred (without the register address of the transaction)
+    uint32_t read_bytes, write_bytes;
+
+    // number of failed bus transactions
+    uint32_t errors;
+
+    // time in µs spent on the bus
+    uint32_t bus_us;
+
+    // time in µs spent in delay_us()
+    uint32_t delay_us;
+  };
+
+  /**
+   * @brief bus statistics of a sensor, broken down per API function
+   *
+   */
+  struct Stats {
+    // statistics indexed by StatsApi
+    ApiStats api[STATS_API_COUNT];
+
+    /**
+     * @brief sum of the statistics of all API functions
+     *
+     * @return statistics
+     */
+    ApiStats total() const {
+      ApiStats sum {0, 0, 0, 0, 0, 0, 0, 0};
+      for (uint8_t i = 0; i < STATS_API_COUNT; ++i) {
+        sum.calls += api[i].calls;
+        sum.reads += api[i].reads;
+        sum.writes += api[i].writes;
+        sum.read_bytes += api[i].read_bytes;
+        sum.write_bytes += api[i].write_bytes;
+        sum.errors += api[i].errors;
+        sum.bus_us += api[i].bus_us;
+        sum.delay_us += api[i].delay_us;
+      }
+      return sum;
+    }
+  };
+}
+#endif
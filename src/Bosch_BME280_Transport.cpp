@@ -0,0 +1,112 @@
+/**
+ * @file    Bosch_BME280_Transport.cpp
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Bus transports (I²C, SPI, mock) for the Bosch BME280 Arduino Wrapper Class
+ */
+#include <Bosch_BME280_Transport.h>
+
+constexpr enum bme280_intf BME::I2CTransport::intf;
+constexpr enum bme280_intf BME::SPITransport::intf;
+constexpr enum bme280_intf BME::MockTransport::intf;
+
+int8_t BME::I2CTransport::read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len) {
+  int8_t result {BME280_OK};
+
+  _wire->beginTransmission(_addr);
+  _wire->write(reg_addr);
+  if (_wire->endTransmission() != 0) {
+    return BME280_E_COMM_FAIL;
+  }
+
+  _wire->requestFrom((int)_addr, (int)len);
+
+  uint32_t available = _wire->available();
+  if (available != len) {
+    result = BME280_E_COMM_FAIL;
+  }
+
+  for (uint32_t i = 0; i < available; i++) {
+    if (i < len) {
+      *(reg_data + i) = _wire->read();
+    }
+    else
+      _wire->read();
+  }
+  return result;
+}
+
+int8_t BME::I2CTransport::write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len) {
+  _wire->beginTransmission(_addr);
+  _wire->write(reg_addr);
+  _wire->write(reg_data, len);
+  if (_wire->endTransmission() != 0) {
+    return BME280_E_COMM_FAIL;
+  }
+  return BME280_OK;
+}
+
+int8_t BME::SPITransport::begin() {
+  pinMode(_cs_pin, OUTPUT);
+  digitalWrite(_cs_pin, HIGH);
+  return BME280_OK;
+}
+
+int8_t BME::SPITransport::read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len) {
+  _spi->beginTransaction(SPISettings(_clock, MSBFIRST, SPI_MODE0));
+  digitalWrite(_cs_pin, LOW);
+  _spi->transfer(reg_addr);
+  for (uint32_t i = 0; i < len; i++) {
+    reg_data[i] = _spi->transfer(0x00);
+  }
+  digitalWrite(_cs_pin, HIGH);
+  _spi->endTransaction();
+  return BME280_OK;
+}
+
+int8_t BME::SPITransport::write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len) {
+  // the Bosch API clears the read flag and interleaves the addresses of a burst write
+  _spi->beginTransaction(SPISettings(_clock, MSBFIRST, SPI_MODE0));
+  digitalWrite(_cs_pin, LOW);
+  _spi->transfer(reg_addr);
+  for (uint32_t i = 0; i < len; i++) {
+    _spi->transfer(reg_data[i]);
+  }
+  digitalWrite(_cs_pin, HIGH);
+  _spi->endTransaction();
+  return BME280_OK;
+}
+
+BME::MockTransport::MockTransport() :
+  _reads {0},
+  _writes {0},
+  _fail {false}
+{
+  memset(_registers, 0, sizeof(_registers));
+}
+
+int8_t BME::MockTransport::read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len) {
+  ++_reads;
+  if (_fail) {
+    return BME280_E_COMM_FAIL;
+  }
+  // SPI read flag is not used, the address auto-increments like the sensor
+  for (uint32_t i = 0; i < len; i++) {
+    reg_data[i] = _registers[(uint8_t)(reg_addr + i)];
+  }
+  return BME280_OK;
+}
+
+int8_t BME::MockTransport::write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len) {
+  ++_writes;
+  if (_fail) {
+    return BME280_E_COMM_FAIL;
+  }
+  // burst write: data, address, data, address, data...
+  _registers[reg_addr] = reg_data[0];
+  for (uint32_t i = 1; i + 1 < len; i += 2) {
+    _registers[reg_data[i]] = reg_data[i + 1];
+  }
+  return BME280_OK;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file    Bosch_BME280_Transport.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Bus transports (I²C, SPI, mock) for the Bosch BME280 Arduino Wrapper Class
+ * 
+ * A transport is a class with the following members:
+ * 
+ *   static constexpr enum bme280_intf intf;        // BME280_I2C_INTF or BME280_SPI_INTF
+ *   int8_t begin();
+ *   int8_t read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len);
+ *   int8_t write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len);
+ * 
+ * The transport is a template parameter of the Bosch_BME280 constructor, so the read and
+ * write functions are bound at compile time and called directly (no virtual functions).
+ */
+#ifndef _BOSCH_BME280_TRANSPORT_H_
+#define _BOSCH_BME280_TRANSPORT_H_
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include "BME280_API/bme280.h"
+
+namespace BME {
+  /**
+   * @brief I²C transport on any TwoWire bus
+   * 
+   */
+  class I2CTransport {
+    public:
+      static constexpr enum bme280_intf intf {BME280_I2C_INTF};
+
+      /**
+       * @brief Construct a new I²C transport
+       * 
+       * @param wire I²C-Bus, Wire.begin() has to be called by the user
+       * @param addr I²C-Address of the sensor
+       */
+      explicit I2CTransport(TwoWire &wire = Wire, uint8_t addr = BME280_I2C_ADDR_PRIM) : _wire {&wire}, _addr {addr} {}
+
+      /**
+       * @brief nothing to do, the bus is initialized by the user
+       * 
+       * @return BME280_OK
+       */
+      int8_t begin() {return BME280_OK;}
+
+      /**
+       * @brief read registers
+       * 
+       * @param reg_addr Register Address
+       * @param reg_data Register Data
+       * @param len count of Bytes
+       * 
+       * @return sensor communication status
+       *
+       * @retval   0: Success
+       * @retval  <0: Fail
+       */
+      int8_t read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len);
+
+      /**
+       * @brief write registers
+       * 
+       * @param reg_addr Register Address
+       * @param reg_data Register Data
+       * @param len count of Bytes
+       * 
+       * @return sensor communication status
+       *
+       * @retval   0: Success
+       * @retval  <0: Fail
+       */
+      int8_t write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len);
+
+    private:
+      TwoWire *_wire;
+      uint8_t _addr;
+  };
+
+  /**
+   * @brief SPI transport with chip select pin
+   * 
+   */
+  class SPITransport {
+    public:
+      static constexpr enum bme280_intf intf {BME280_SPI_INTF};
+
+      /**
+       * @brief Construct a new SPI transport
+       * 
+       * @param spi SPI-Bus, SPI.begin() has to be called by the user
+       * @param cs_pin chip select pin of the sensor
+       * @param clock SPI clock in Hz (BME280 max. 10 MHz)
+       */
+      SPITransport(SPIClass &spi, uint8_t cs_pin, uint32_t clock = 10000000UL) : _spi {&spi}, _cs_pin {cs_pin}, _clock {clock} {}
+
+      /**
+       * @brief configure the chip select pin
+       * 
+       * The first falling edge of CS switches the sensor to SPI mode.
+       * 
+       * @return BME280_OK
+       */
+      int8_t begin();
+
+      /**
+       * @brief read registers, the read flag (0x80) is set by the Bosch API
+       * 
+       * @param reg_addr Register Address
+       * @param reg_data Register Data
+       * @param len count of Bytes
+       * 
+       * @return sensor communication status
+       *
+       * @retval   0: Success
+       */
+      int8_t read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len);
+
+      /**
+       * @brief write registers
+       * 
+       * @param reg_addr Register Address
+       * @param reg_data Register Data
+       * @param len count of Bytes
+       * 
+       * @return sensor communication status
+       *
+       * @retval   0: Success
+       */
+      int8_t write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len);
+
+    private:
+      SPIClass *_spi;
+      uint8_t _cs_pin;
+      uint32_t _clock;
+  };
+
+  /**
+   * @brief mock transport on a register map in RAM, e.g. for tests without sensor
+   * 
+   * Burst writes are decoded like the sensor does (address, data, address, data...).
+   * The transactions are counted.
+   */
+  class MockTransport {
+    public:
+      static constexpr enum bme280_intf intf {BME280_I2C_INTF};
+
+      MockTransport();
+
+      /**
+       * @brief nothing to do
+       * 
+       * @return BME280_OK
+       */
+      int8_t begin() {return BME280_OK;}
+
+      /**
+       * @brief read from the register map
+       * 
+       * @param reg_addr Register Address
+       * @param reg_data Register Data
+       * @param len count of Bytes
+       * 
+       * @return BME280_E_COMM_FAIL if a failure is injected, else BME280_OK
+       */
+      int8_t read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len);
+
+      /**
+       * @brief write into the register map
+       * 
+       * @param reg_addr Register Address
+       * @param reg_data Register Data
+       * @param len count of Bytes
+       * 
+       * @return BME280_E_COMM_FAIL if a failure is injected, else BME280_OK
+       */
+      int8_t write(uint8_t reg_addr, const uint8_t *reg_data, uint32_t len);
+
+      /**
+       * @brief access a register of the mocked device
+       * 
+       * @param reg_addr Register Address
+       * @return register content
+       */
+      uint8_t &reg(uint8_t reg_addr) {return _registers[reg_addr];}
+
+      /**
+       * @brief Get the number of read transactions
+       * 
+       * @return number of reads
+       */
+      uint32_t getReads() const {return _reads;}
+
+      /**
+       * @brief Get the number of write transactions
+       * 
+       * @return number of writes
+       */
+      uint32_t getWrites() const {return _writes;}
+
+      /**
+       * @brief inject bus failures
+       * 
+       * @param fail if true all transactions fail with BME280_E_COMM_FAIL
+       */
+      void setFail(bool fail) {_fail = fail;}
+
+    private:
+      // register map of the mocked device
+      uint8_t _registers[256];
+
+      // transaction counters
+      uint32_t _reads, _writes;
+
+      // failure injection
+      bool _fail;
+  };
+}
+#endif
@@ -0,0 +1,10 @@
+/*
+ * Host build of the sketch Compensation_benchmark.ino, prints the same machine readable rows as on target.
+ * On the host F_CPU is a nominal 1 GHz, so cycles_per_call is the time per call in ns.
+ */
+#include "../../examples/Compensation_benchmark/Compensation_benchmark.ino"
+
+int main() {
+  setup();
+  return 0;
+}
@@ -0,0 +1,10 @@
+/*
+ * Host build of the sketch Measurement_benchmark.ino, prints the same machine readable rows as on target.
+ * delay() only advances the clock, so the latency includes the simulated conversion time without waiting.
+ */
+#include "../../examples/Measurement_benchmark/Measurement_benchmark.ino"
+
+int main() {
+  setup();
+  return 0;
+}
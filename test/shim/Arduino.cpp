@@ -0,0 +1,103 @@
+/**
+ * @file    Arduino.cpp
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Minimal Arduino core for the host build of the library (tests and benchmarks)
+ */
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <chrono>
+#include <stdio.h>
+
+HardwareSerial Serial;
+TwoWire Wire;
+SPIClass SPI;
+
+namespace {
+  const std::chrono::steady_clock::time_point start_time {std::chrono::steady_clock::now()};
+
+  // time advanced by delay() and delayMicroseconds() and the counters since the last reset
+  uint64_t delay_offset {0};
+  uint32_t delay_calls {0};
+  uint32_t delay_time {0};
+
+  void advance(uint32_t us) {
+    delay_offset += us;
+    delay_time += us;
+    ++delay_calls;
+  }
+}
+
+uint32_t micros() {
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+  return (uint32_t)(elapsed.count() + delay_offset);
+}
+
+uint32_t millis() {
+  return micros() / 1000UL;
+}
+
+void delay(uint32_t ms) {
+  advance(ms * 1000UL);
+}
+
+void delayMicroseconds(uint32_t us) {
+  advance(us);
+}
+
+void yield() {
+}
+
+void pinMode(uint8_t, uint8_t) {
+}
+
+void digitalWrite(uint8_t, uint8_t) {
+}
+
+size_t Print::write(const char *str) {
+  size_t n {0};
+  while (*str != '\0') {
+    n += write((uint8_t)*str++);
+  }
+  return n;
+}
+
+size_t Print::print(long value, int base) {
+  if (base == DEC) {
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), "%ld", value);
+    return write(buffer);
+  }
+  return print((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+  char buffer[24];
+  snprintf(buffer, sizeof(buffer), (base == HEX) ? "%lX" : "%lu", value);
+  return write(buffer);
+}
+
+size_t Print::print(double value, int digits) {
+  char buffer[48];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return write(buffer);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return (putchar(c) == EOF) ? 0 : 1;
+}
+
+uint32_t ArduinoShim::delayCalls() {
+  return delay_calls;
+}
+
+uint32_t ArduinoShim::delayTime() {
+  return delay_time;
+}
+
+void ArduinoShim::reset() {
+  delay_calls = 0;
+  delay_time = 0;
+}
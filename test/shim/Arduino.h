@@ -0,0 +1,108 @@
+/**
+ * @file    Arduino.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Minimal Arduino core for the host build of the library (tests and benchmarks)
+ *
+ * The time base is the real time of the host plus the time of delay() and delayMicroseconds(),
+ * which return immediately and only advance the clock. So the sensor simulator sees the waits,
+ * but the tests do not sleep.
+ */
+#ifndef _ARDUINO_SHIM_H_
+#define _ARDUINO_SHIM_H_
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define PI 3.1415926535897932384626433832795
+#define DEC 10
+#define HEX 16
+#define INPUT 0
+#define OUTPUT 1
+#define LOW 0
+#define HIGH 1
+
+// the host has no fixed clock, a nominal 1 GHz reports cycles as ns
+#ifndef F_CPU
+#define F_CPU 1000000000UL
+#endif
+
+typedef uint8_t byte;
+
+uint32_t micros();
+uint32_t millis();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+/**
+ * @brief text output like the Print class of the Arduino core
+ *
+ */
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    size_t write(const char *str);
+
+    size_t print(const __FlashStringHelper *str) {return write(reinterpret_cast<const char *>(str));}
+    size_t print(const char *str) {return write(str);}
+    size_t print(char c) {return write((uint8_t)c);}
+    size_t print(unsigned char value, int base = DEC) {return print((unsigned long)value, base);}
+    size_t print(int value, int base = DEC) {return print((long)value, base);}
+    size_t print(unsigned int value, int base = DEC) {return print((unsigned long)value, base);}
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println() {return write("\r\n");}
+    template <class T>
+    size_t println(T value) {return print(value) + println();}
+    template <class T>
+    size_t println(T value, int format) {return print(value, format) + println();}
+};
+
+/**
+ * @brief serial port, writes to stdout
+ *
+ */
+class HardwareSerial : public Print {
+  public:
+    void begin(unsigned long) {}
+    operator bool() const {return true;}
+    size_t write(uint8_t c) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+namespace ArduinoShim {
+  /**
+   * @brief number of calls of delay() and delayMicroseconds()
+   *
+   * @return number of calls since the last reset()
+   */
+  uint32_t delayCalls();
+
+  /**
+   * @brief time in µs spent in delay() and delayMicroseconds()
+   *
+   * @return time since the last reset()
+   */
+  uint32_t delayTime();
+
+  /**
+   * @brief reset the delay counters, the clock keeps running
+   *
+   */
+  void reset();
+}
+#endif
@@ -0,0 +1,28 @@
+/**
+ * @file    SPI.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   SPI-Bus of the host build without devices (reads 0xFF)
+ */
+#ifndef _SPI_SHIM_H_
+#define _SPI_SHIM_H_
+#include <Arduino.h>
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+struct SPISettings {
+  SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass {
+  public:
+    void begin() {}
+    void beginTransaction(SPISettings) {}
+    uint8_t transfer(uint8_t) {return 0xFF;}
+    void endTransaction() {}
+};
+
+extern SPIClass SPI;
+#endif
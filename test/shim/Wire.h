@@ -0,0 +1,26 @@
+/**
+ * @file    Wire.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   I²C-Bus of the host build without devices (every address is not acknowledged)
+ */
+#ifndef _WIRE_SHIM_H_
+#define _WIRE_SHIM_H_
+#include <Arduino.h>
+
+class TwoWire {
+  public:
+    void begin() {}
+    void beginTransmission(uint8_t) {}
+    size_t write(uint8_t) {return 1;}
+    size_t write(const uint8_t *, size_t len) {return len;}
+    // 2: address not acknowledged
+    uint8_t endTransmission(bool = true) {return 2;}
+    uint8_t requestFrom(int, int) {return 0;}
+    int available() {return 0;}
+    int read() {return -1;}
+};
+
+extern TwoWire Wire;
+#endif
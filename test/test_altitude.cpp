@@ -0,0 +1,68 @@
+/*
+ * Host test of the sea level factor and the altitude helpers against the exact barometric formula.
+ *
+ * seaLevelFactor() (series, constexpr) has to match (1 - altitude / 44330)^-5.255 to the float resolution
+ * from -5000 to 20000 m, altitudeFromPressure() (polynomial) the inverse formula within 0.83 m from
+ * 0.3 to 1.1 of the sea level pressure.
+ */
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+#include <Bosch_BME280_Simulator.h>
+#include "test_helper.h"
+
+TEST_MAIN;
+
+namespace {
+  // evaluated by the compiler
+  constexpr float FACTOR_CONSTANT {BME::seaLevelFactor(249.67)};
+
+  void testSeaLevelFactor() {
+    double max_error {0.0};
+    for (int32_t altitude = -5000; altitude <= 20000; ++altitude) {
+      double exact = pow(1.0 - altitude / 44330.0, -5.255);
+      double error = fabs(BME::seaLevelFactor(altitude) - exact) / exact;
+      if (error > max_error) {
+        max_error = error;
+      }
+    }
+    printf("sea level factor: max. relative error %.3g\n", max_error);
+    // the rounding to float: half an ulp is 2^-24 = 5.96e-8
+    CHECK(max_error < 6.0e-8);
+    CHECK(FACTOR_CONSTANT == BME::seaLevelFactor(249.67));
+  }
+
+  void testAltitudeFromPressure() {
+    const float sealevel {1013.25F};
+    double max_error {0.0};
+    // 0.1 hPa steps from 0.3 to 1.1 of the sea level pressure
+    for (int32_t i = 3040; i <= 11145; ++i) {
+      float pressure = i / 10.0F;
+      double exact = 44330.0 * (1.0 - pow(pressure / (double)sealevel, 1.0 / 5.255));
+      double error = fabs(BME::altitudeFromPressure(pressure, sealevel) - exact);
+      if (error > max_error) {
+        max_error = error;
+      }
+    }
+    printf("altitude: max. error %.3f m\n", max_error);
+    CHECK(max_error < 0.83);
+  }
+
+  void testWrapper() {
+    BME::SimulatedBME280 sim;
+    sim.setEnvironment(BME::Environment {20.0F, 95000.0F, 50.0F});
+    BME::Bosch_BME280 bme {sim, 500.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+    CHECK(bme.measure() == BME280_OK);
+    // the sea level pressure of the altitude gives back the altitude
+    CHECK_NEAR(bme.getAltitudeForSealevel(bme.getSealevelForAltitude()), 500.0, 1.0);
+    bme.setAltitude(0.0F);
+    CHECK(bme.getSealevelForAltitude() == bme.getPressure());
+  }
+}
+
+int main() {
+  testSeaLevelFactor();
+  testAltitudeFromPressure();
+  testWrapper();
+  return test::result();
+}
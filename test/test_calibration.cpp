@@ -0,0 +1,93 @@
+/*
+ * Host test of the calibration data export and import.
+ *
+ * serializeCalibData() / deserializeCalibData() must restore the calibration data of the simulated sensor,
+ * a corrupted block is rejected by the CRC-16. With calibration data set before begin() the NVM is not read.
+ */
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+#include <Bosch_BME280_Simulator.h>
+#include "test_helper.h"
+
+TEST_MAIN;
+
+namespace {
+  bool equal(const struct bme280_calib_data &a, const struct bme280_calib_data &b) {
+    return a.dig_t1 == b.dig_t1 && a.dig_t2 == b.dig_t2 && a.dig_t3 == b.dig_t3 &&
+           a.dig_p1 == b.dig_p1 && a.dig_p2 == b.dig_p2 && a.dig_p3 == b.dig_p3 &&
+           a.dig_p4 == b.dig_p4 && a.dig_p5 == b.dig_p5 && a.dig_p6 == b.dig_p6 &&
+           a.dig_p7 == b.dig_p7 && a.dig_p8 == b.dig_p8 && a.dig_p9 == b.dig_p9 &&
+           a.dig_h1 == b.dig_h1 && a.dig_h2 == b.dig_h2 && a.dig_h3 == b.dig_h3 &&
+           a.dig_h4 == b.dig_h4 && a.dig_h5 == b.dig_h5 && a.dig_h6 == b.dig_h6;
+  }
+
+  void testCrc() {
+    // check value of CRC-16/CCITT-FALSE
+    const uint8_t data[] {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    CHECK(BME::crc16(data, sizeof(data)) == 0x29B1);
+  }
+
+  void testRoundTrip() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+    uint8_t buffer[BME::CALIB_DATA_SIZE];
+    BME::serializeCalibData(bme.getCalibData(), buffer);
+    struct bme280_calib_data calib {};
+    CHECK(BME::deserializeCalibData(buffer, calib));
+    CHECK(equal(calib, bme.getCalibData()));
+  }
+
+  void testCorruption() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+    uint8_t buffer[BME::CALIB_DATA_SIZE];
+    BME::serializeCalibData(bme.getCalibData(), buffer);
+
+    // every single bit error of the version, the values and the CRC is detected
+    uint32_t accepted {0};
+    for (uint8_t i = 0; i < BME::CALIB_DATA_SIZE; ++i) {
+      for (uint8_t bit = 0; bit < 8; ++bit) {
+        buffer[i] ^= (uint8_t)(1 << bit);
+        struct bme280_calib_data calib {};
+        if (BME::deserializeCalibData(buffer, calib) || calib.dig_t1 != 0) {
+          ++accepted;
+        }
+        buffer[i] ^= (uint8_t)(1 << bit);
+      }
+    }
+    CHECK(accepted == 0);
+  }
+
+  void testBeginWithCalibData() {
+    BME::SimulatedBME280 sim;
+    uint32_t reads;
+    struct bme280_calib_data calib;
+    {
+      BME::Bosch_BME280 bme {sim, 0.0F, true};
+      sim.resetCounters();
+      CHECK(bme.begin() == BME280_OK);
+      reads = sim.getCounters().reads;
+      calib = bme.getCalibData();
+    }
+
+    // the chip id is read, the two blocks of the calibration NVM are not
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    bme.setCalibData(calib);
+    sim.resetCounters();
+    CHECK(bme.begin() == BME280_OK);
+    CHECK(sim.getCounters().reads == reads - 2);
+    CHECK(equal(bme.getCalibData(), calib));
+    CHECK(bme.measure() == BME280_OK);
+    CHECK_NEAR(bme.getTemperature(), 20.0, 0.02);
+  }
+}
+
+int main() {
+  testCrc();
+  testRoundTrip();
+  testCorruption();
+  testBeginWithCalibData();
+  return test::result();
+}
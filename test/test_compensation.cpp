@@ -0,0 +1,114 @@
+/*
+ * Host test of the deferred compensation against the getters of the wrapper.
+ *
+ * compensateSamples() has to return exactly the values of the getters in every compensation mode
+ * (double, float, 32 bit and 64 bit), the quantities are swept independently over the range of the sensor.
+ * In raw capture mode the getters keep their values and the captured samples are compensated in one batch.
+ */
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+#include <Bosch_BME280_Simulator.h>
+#include "test_helper.h"
+
+TEST_MAIN;
+
+namespace {
+  const uint8_t SAMPLES {32};
+
+  // values of the getters after one measurement
+  struct GetterValues {
+    float temperature, pressure, humidity;
+    int32_t temperature_int;
+    uint32_t pressure_int, humidity_int;
+  };
+
+  GetterValues getterValues(const BME::Bosch_BME280 &bme) {
+    return GetterValues {bme.getTemperature(), bme.getPressure(), bme.getHumidity(),
+                         bme.getTemperatureInt(), bme.getPressureInt(), bme.getHumidityInt()};
+  }
+
+  // the conversion of the getters in the compensation mode of the build
+  void checkBatch(const struct bme280_data &data, const GetterValues &values) {
+#ifdef BME280_DOUBLE_ENABLE
+    CHECK((float) data.temperature == values.temperature);
+    CHECK((float) data.pressure / 100.0F == values.pressure);
+    CHECK((float) data.humidity == values.humidity);
+    CHECK((int32_t) lround(data.temperature * 100.0) == values.temperature_int);
+    CHECK((uint32_t) lround(data.pressure * 100.0) == values.pressure_int);
+    CHECK((uint32_t) lround(data.humidity * 1024.0) == values.humidity_int);
+#else
+    CHECK(data.temperature == values.temperature_int);
+    CHECK(data.humidity == values.humidity_int);
+#ifdef BME280_32BIT_ENABLE
+    CHECK(data.pressure * 100UL == values.pressure_int);
+#else
+    CHECK(data.pressure == values.pressure_int);
+#endif
+#endif
+  }
+
+  void testBatchAgainstGetters() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+
+    struct bme280_uncomp_data raw[SAMPLES];
+    GetterValues values[SAMPLES];
+    for (uint8_t i = 0; i < SAMPLES; ++i) {
+      // independent steps of the three quantities
+      float temperature = -40.0F + 125.0F * i / (SAMPLES - 1);
+      float pressure = 30000.0F + 80000.0F * ((i * 7) % SAMPLES) / (SAMPLES - 1);
+      float humidity = 100.0F * ((i * 13) % SAMPLES) / (SAMPLES - 1);
+      sim.setEnvironment(BME::Environment {temperature, pressure, humidity});
+      CHECK(bme.measure() == BME280_OK);
+      raw[i] = bme.getRawData();
+      values[i] = getterValues(bme);
+    }
+
+    struct bme280_data data[SAMPLES];
+    CHECK(BME::compensateSamples(raw, data, SAMPLES, bme.getCalibData()) == BME280_OK);
+    for (uint8_t i = 0; i < SAMPLES; ++i) {
+      checkBatch(data[i], values[i]);
+    }
+  }
+
+  void testRawCapture() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    BME::RawSampleBuffer<8> buffer;
+    bme.setRawSampleBuffer(&buffer);
+    CHECK(bme.begin() == BME280_OK);
+    sim.setEnvironment(BME::Environment {21.5F, 98765.0F, 42.0F});
+    CHECK(bme.measure() == BME280_OK);
+    GetterValues first = getterValues(bme);
+
+    // raw capture: the getters keep the values of the last compensated measurement
+    bme.setRawCapture(true);
+    for (uint8_t i = 0; i < 4; ++i) {
+      sim.setEnvironment(BME::Environment {10.0F + 5.0F * i, 90000.0F + 5000.0F * i, 20.0F + 10.0F * i});
+      CHECK(bme.measure() == BME280_OK);
+      CHECK(bme.getTemperatureInt() == first.temperature_int);
+      CHECK(bme.getPressureInt() == first.pressure_int);
+      CHECK(bme.getHumidityInt() == first.humidity_int);
+    }
+
+    // deferred compensation of the captured samples
+    struct bme280_uncomp_data raw[8];
+    struct bme280_data data[8];
+    uint16_t n = buffer.drain(raw, 8);
+    CHECK(n == 5);
+    CHECK(BME::compensateSamples(raw, data, n, bme.getCalibData()) == BME280_OK);
+    checkBatch(data[0], first);
+
+    // the same environment measured without raw capture gives the values of the batch
+    bme.setRawCapture(false);
+    CHECK(bme.measure() == BME280_OK);
+    checkBatch(data[n - 1], getterValues(bme));
+  }
+}
+
+int main() {
+  testBatchAgainstGetters();
+  testRawCapture();
+  return test::result();
+}
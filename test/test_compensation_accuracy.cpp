@@ -0,0 +1,10 @@
+/*
+ * Host build of the sketch Compensation_accuracy.ino: the maximum errors of the single precision compensation
+ * against the compensation mode of the build have to stay below the limits of the sketch.
+ */
+#include "../examples/Compensation_accuracy/Compensation_accuracy.ino"
+
+int main() {
+  setup();
+  return (failures == 0) ? 0 : 1;
+}
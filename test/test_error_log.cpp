@@ -0,0 +1,83 @@
+/*
+ * Host test of the error log.
+ *
+ * The ring buffer keeps the last BME280_ERROR_LOG_SIZE entries oldest first, the counters per source
+ * count all errors. The wrapper records its bus errors with the function which reported them.
+ */
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+#include <Bosch_BME280_Simulator.h>
+#include "test_helper.h"
+
+TEST_MAIN;
+
+namespace {
+  void testWrap() {
+    BME::ErrorLog log;
+    CHECK(log.capacity() == BME280_ERROR_LOG_SIZE);
+    // 10 errors: read, write, read, write, ..., the codes count down from -1
+    for (int8_t i = 0; i < 10; ++i) {
+      BME::ErrorSource source = (i % 2 == 0) ? BME::ERROR_READ : BME::ERROR_WRITE;
+      BME::ErrorEntry entry = log.record(source, (int8_t)(-1 - i));
+      CHECK(entry.source == source);
+      CHECK(entry.code == -1 - i);
+    }
+    CHECK(log.size() == 8);
+    CHECK(log.overruns() == 2);
+    CHECK(log.count(BME::ERROR_READ) == 5);
+    CHECK(log.count(BME::ERROR_WRITE) == 5);
+    CHECK(log.count(BME::ERROR_BEGIN) == 0);
+    CHECK(log.total() == 10);
+
+    // the last 8 entries, the oldest first
+    BME::ErrorEntry entries[BME280_ERROR_LOG_SIZE];
+    CHECK(log.drain(entries, BME280_ERROR_LOG_SIZE) == 8);
+    for (uint8_t i = 0; i < 8; ++i) {
+      CHECK(entries[i].code == -3 - i);
+      CHECK(entries[i].source == ((i % 2 == 0) ? BME::ERROR_READ : BME::ERROR_WRITE));
+    }
+    // the counters are kept until clear()
+    CHECK(log.total() == 10);
+    log.clear();
+    CHECK(log.total() == 0);
+    CHECK(log.overruns() == 0);
+  }
+
+  void testPrint() {
+    BME::ErrorLog log;
+    log.record(BME::ERROR_BEGIN, BME280_E_DEV_NOT_FOUND);
+    log.record(BME::ERROR_SYNCHRONIZE, BME::E_MEAS_TIMEOUT);
+    CHECK(log.print(Serial) == 2);
+    CHECK(log.size() == 0);
+    CHECK(log.total() == 2);
+  }
+
+  void testWrapper() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+    CHECK(bme.getErrorLog().total() == 0);
+    sim.setFail(true);
+    // the trigger write fails
+    CHECK(bme.measure() == BME280_E_COMM_FAIL);
+    CHECK(bme.getErrorLog().count(BME::ERROR_WRITE) == 1);
+    CHECK(bme.begin() == BME280_E_COMM_FAIL);
+    CHECK(bme.getErrorLog().count(BME::ERROR_BEGIN) == 1);
+    sim.setFail(false);
+    CHECK(bme.measure() == BME280_OK);
+    CHECK(bme.getErrorLog().total() == 2);
+
+    BME::ErrorEntry entries[BME280_ERROR_LOG_SIZE];
+    CHECK(bme.getErrorLog().drain(entries, BME280_ERROR_LOG_SIZE) == 2);
+    CHECK(entries[0].source == BME::ERROR_WRITE);
+    CHECK(entries[1].source == BME::ERROR_BEGIN);
+    CHECK(entries[1].code == BME280_E_COMM_FAIL);
+  }
+}
+
+int main() {
+  testWrap();
+  testPrint();
+  testWrapper();
+  return test::result();
+}
@@ -0,0 +1,37 @@
+/**
+ * @file    test_helper.h
+ * @author  Frank Häfele
+ * @date    21.02.2022
+ * @version 1.2.0
+ * @brief   Checks of the host tests, a failed check is printed and the test returns 1
+ */
+#ifndef _TEST_HELPER_H_
+#define _TEST_HELPER_H_
+#include <stdio.h>
+#include <math.h>
+
+namespace test {
+  // number of failed checks
+  extern int failures;
+
+  inline void check(bool condition, const char *expression, const char *file, int line) {
+    if (!condition) {
+      printf("%s:%d: check failed: %s\n", file, line, expression);
+      ++failures;
+    }
+  }
+
+  // result of main()
+  inline int result() {
+    printf("%s\n", (failures == 0) ? "passed" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+  }
+}
+
+#define CHECK(condition) test::check((condition), #condition, __FILE__, __LINE__)
+#define CHECK_NEAR(value, expected, tolerance) \
+  test::check(fabs((double)(value) - (double)(expected)) <= (tolerance), #value " ~ " #expected, __FILE__, __LINE__)
+
+// definition of the failure counter, once per test executable
+#define TEST_MAIN int test::failures {0}
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Host test of the non-blocking measurement: startMeasurement() and poll() never wait.
+ *
+ * Every call issues at most one bus transaction (with status polling: the status register and, when the
+ * conversion is finished, the data burst) and never calls delay_us(), so loop() is not blocked longer
+ * than the bus transfer.
+ */
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+#include <Bosch_BME280_Simulator.h>
+#include "test_helper.h"
+
+TEST_MAIN;
+
+namespace {
+  // bus transactions of the simulated sensor
+  uint32_t transactions(const BME::SimulatedBME280 &sim) {
+    return sim.getCounters().reads + sim.getCounters().writes;
+  }
+
+  // run one measurement with startMeasurement() / poll() and check every call
+  void checkMeasurement(BME::SimulatedBME280 &sim, BME::Bosch_BME280 &bme, uint32_t max_poll_transactions) {
+    sim.resetCounters();
+    ArduinoShim::reset();
+    CHECK(bme.startMeasurement() == BME280_OK);
+    CHECK(transactions(sim) <= 1);
+    CHECK(ArduinoShim::delayCalls() == 0);
+    CHECK(bme.isMeasuring());
+
+    uint32_t polls {0};
+    while (!bme.isReady() && polls < 1000) {
+      // the time of the other tasks in loop()
+      delayMicroseconds(100);
+      uint32_t before = transactions(sim);
+      ArduinoShim::reset();
+      CHECK(bme.poll() == BME280_OK);
+      CHECK(transactions(sim) - before <= max_poll_transactions);
+      CHECK(ArduinoShim::delayCalls() == 0);
+      ++polls;
+    }
+    CHECK(bme.isReady());
+    CHECK(!bme.isMeasuring());
+    // the result is read once
+    CHECK(sim.getCounters().read_bytes >= BME280_LEN_P_T_H_DATA);
+    CHECK_NEAR(bme.getTemperature(), 20.0, 0.02);
+  }
+
+  void testForcedMode() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+    for (uint8_t i = 0; i < 3; ++i) {
+      checkMeasurement(sim, bme, 1);
+    }
+  }
+
+  void testForcedModeStatusPolling() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+    bme.setStatusPolling(true, 500, 0);
+    for (uint8_t i = 0; i < 3; ++i) {
+      checkMeasurement(sim, bme, 2);
+    }
+  }
+
+  void testNormalMode() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, false};
+    CHECK(bme.begin() == BME280_OK);
+    for (uint8_t i = 0; i < 3; ++i) {
+      checkMeasurement(sim, bme, 1);
+    }
+  }
+}
+
+int main() {
+  testForcedMode();
+  testForcedModeStatusPolling();
+  testNormalMode();
+  return test::result();
+}
@@ -0,0 +1,128 @@
+/*
+ * Host round trip test of the packed sample format.
+ *
+ * packSample() / unpackSample() and packSampleDelta() / unpackSampleDelta() must restore the raw values
+ * bit-exact. The delta stream starts with a zero previous sample and falls back to the plain packed sample
+ * for large steps, with a header only for raw pressures below 0x40000.
+ */
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+#include "test_helper.h"
+
+TEST_MAIN;
+
+namespace {
+  // deterministic pseudo random numbers (xorshift32)
+  uint32_t state {2463534242UL};
+  uint32_t random32() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+
+  // random value in -range...range
+  int32_t randomStep(int32_t range) {
+    return (int32_t)(random32() % (uint32_t)(2 * range + 1)) - range;
+  }
+
+  bool equal(const struct bme280_uncomp_data &a, const struct bme280_uncomp_data &b) {
+    return a.pressure == b.pressure && a.temperature == b.temperature && a.humidity == b.humidity;
+  }
+
+  void testAbsolute() {
+    const struct bme280_uncomp_data samples[] {
+      {0, 0, 0},
+      {0xFFFFF, 0xFFFFF, 0xFFFF},
+      {415148, 519888, 30000},
+      {0x80000, 0x80000, 0x8000}
+    };
+    for (const struct bme280_uncomp_data &raw : samples) {
+      uint8_t buffer[BME::PACKED_SAMPLE_SIZE];
+      BME::packSample(raw, buffer);
+      struct bme280_uncomp_data restored;
+      BME::unpackSample(buffer, restored);
+      CHECK(equal(raw, restored));
+    }
+  }
+
+  void testFirstSampleAndFallback() {
+    const struct bme280_uncomp_data zero {0, 0, 0};
+    const struct bme280_uncomp_data raw {415148, 519888, 30000};
+    uint8_t buffer[BME::PACKED_DELTA_MAX_SIZE];
+    uint8_t packed[BME::PACKED_SAMPLE_SIZE];
+    struct bme280_uncomp_data restored;
+
+    // first sample of a stream: delta against zero does not fit, plain packed sample without header
+    uint8_t len = BME::packSampleDelta(raw, zero, buffer);
+    CHECK(len == BME::PACKED_SAMPLE_SIZE);
+    BME::packSample(raw, packed);
+    CHECK(memcmp(buffer, packed, BME::PACKED_SAMPLE_SIZE) == 0);
+    CHECK(BME::unpackSampleDelta(buffer, zero, restored) == len);
+    CHECK(equal(raw, restored));
+
+    // unchanged sample: header only
+    len = BME::packSampleDelta(raw, raw, buffer);
+    CHECK(len == 1);
+    CHECK(BME::unpackSampleDelta(buffer, raw, restored) == len);
+    CHECK(equal(raw, restored));
+
+    // large step of every value: plain packed sample
+    const struct bme280_uncomp_data jump {815148, 919888, 60000};
+    len = BME::packSampleDelta(jump, raw, buffer);
+    CHECK(len == BME::PACKED_SAMPLE_SIZE);
+    CHECK(BME::unpackSampleDelta(buffer, raw, restored) == len);
+    CHECK(equal(jump, restored));
+
+    // raw pressure below 0x40000 (above 1100 hPa): the packed sample needs the header 0x3F
+    const struct bme280_uncomp_data low {15148, 919888, 60000};
+    len = BME::packSampleDelta(low, raw, buffer);
+    CHECK(len == BME::PACKED_DELTA_MAX_SIZE);
+    CHECK(buffer[0] == 0x3F);
+    CHECK(BME::unpackSampleDelta(buffer, raw, restored) == len);
+    CHECK(equal(low, restored));
+  }
+
+  void testRandomWalk() {
+    const uint32_t count {100000};
+    struct bme280_uncomp_data previous {0, 0, 0}, decoded_previous {0, 0, 0};
+    uint32_t bytes {0}, errors {0};
+    for (uint32_t i = 0; i < count; ++i) {
+      struct bme280_uncomp_data raw;
+      if (i % 1000 == 0) {
+        // jump to a random value
+        raw = {random32() & 0xFFFFF, random32() & 0xFFFFF, random32() & 0xFFFF};
+      }
+      else {
+        raw = {(uint32_t)(previous.pressure + randomStep(20)) & 0xFFFFF,
+               (uint32_t)(previous.temperature + randomStep(10)) & 0xFFFFF,
+               (uint32_t)(previous.humidity + randomStep(150)) & 0xFFFF};
+      }
+      uint8_t buffer[BME::PACKED_DELTA_MAX_SIZE];
+      uint8_t len = BME::packSampleDelta(raw, previous, buffer);
+      struct bme280_uncomp_data restored;
+      if (BME::unpackSampleDelta(buffer, decoded_previous, restored) != len || !equal(raw, restored)) {
+        ++errors;
+      }
+      // 8 bytes only for raw pressures below 0x40000
+      if (len > BME::PACKED_SAMPLE_SIZE && raw.pressure >= 0x40000) {
+        ++errors;
+      }
+      bytes += len;
+      previous = raw;
+      decoded_previous = restored;
+    }
+    CHECK(errors == 0);
+    // typical size of a delta encoded sample is below the 7 bytes of the absolute format
+    float bytes_per_sample = (float)bytes / count;
+    printf("random walk: %.2f bytes per sample\n", bytes_per_sample);
+    CHECK(bytes_per_sample < 5.0F);
+  }
+}
+
+int main() {
+  testAbsolute();
+  testFirstSampleAndFallback();
+  testRandomWalk();
+  return test::result();
+}
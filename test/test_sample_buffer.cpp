@@ -0,0 +1,91 @@
+/*
+ * Host test of the allocation free sample ring buffer.
+ *
+ * A full buffer overwrites the oldest record and counts it as overrun, drain() returns the records
+ * oldest first, also across the end of the storage. The wrapper pushes one record per measurement.
+ */
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+#include <Bosch_BME280_Simulator.h>
+#include "test_helper.h"
+
+TEST_MAIN;
+
+namespace {
+  BME::SampleRecord record(uint32_t timestamp) {
+    return BME::SampleRecord {timestamp, 0, 0, 0};
+  }
+
+  void testOverrun() {
+    BME::SampleBuffer<4> buffer;
+    CHECK(buffer.capacity() == 4);
+    for (uint32_t i = 1; i <= 6; ++i) {
+      buffer.push(record(i));
+    }
+    CHECK(buffer.size() == 4);
+    CHECK(buffer.overruns() == 2);
+
+    // the last 4 records, oldest first
+    BME::SampleRecord records[8];
+    CHECK(buffer.drain(records, 8) == 4);
+    for (uint32_t i = 0; i < 4; ++i) {
+      CHECK(records[i].timestamp == i + 3);
+    }
+    CHECK(buffer.size() == 0);
+    CHECK(buffer.drain(records, 8) == 0);
+
+    buffer.clear();
+    CHECK(buffer.overruns() == 0);
+  }
+
+  void testPartialDrain() {
+    BME::SampleBuffer<4> buffer;
+    BME::SampleRecord records[4];
+    uint32_t next {1}, expected {1};
+    // the tail moves around the storage, drain() copies across its end
+    for (uint8_t round = 0; round < 5; ++round) {
+      for (uint8_t i = 0; i < 3; ++i) {
+        buffer.push(record(next++));
+      }
+      uint16_t n = buffer.drain(records, 2);
+      CHECK(n == 2);
+      for (uint16_t i = 0; i < n; ++i) {
+        CHECK(records[i].timestamp == expected++);
+      }
+      n = buffer.drain(records, 4);
+      CHECK(n == 1);
+      CHECK(records[0].timestamp == expected++);
+    }
+    CHECK(buffer.overruns() == 0);
+  }
+
+  void testMeasurementRecords() {
+    BME::SimulatedBME280 sim;
+    sim.setEnvironment(BME::Environment {21.5F, 98765.0F, 42.0F});
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    BME::SampleBuffer<4> buffer;
+    bme.setSampleBuffer(&buffer);
+    CHECK(bme.begin() == BME280_OK);
+    for (uint8_t i = 0; i < 3; ++i) {
+      CHECK(bme.measure() == BME280_OK);
+    }
+    BME::SampleRecord records[4];
+    CHECK(buffer.drain(records, 4) == 3);
+    // the last record is the one of the last measurement
+    BME::SampleRecord last = bme.getSampleRecord();
+    CHECK(records[2].timestamp == last.timestamp);
+    CHECK(records[2].pressure == last.pressure);
+    CHECK(records[2].temperature == last.temperature);
+    CHECK(records[2].humidity == last.humidity);
+    CHECK_NEAR(records[0].pressure / 100.0, 98765.0, 10.0);
+    CHECK_NEAR(records[0].temperature / 100.0, 21.5, 0.02);
+    CHECK_NEAR(records[0].humidity / 100.0, 42.0, 0.1);
+  }
+}
+
+int main() {
+  testOverrun();
+  testPartialDrain();
+  testMeasurementRecords();
+  return test::result();
+}
@@ -0,0 +1,233 @@
+/*
+ * Host test of the wrapper and the Bosch driver against the simulated sensor.
+ *
+ * Checks the register map of the simulator (chip id, calibration NVM, ctrl/config/status, data registers),
+ * the compensated values against the environment, the bus transactions of forced and normal mode,
+ * the counters of the normal mode scheduler and resume().
+ */
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+#include <Bosch_BME280_Simulator.h>
+#include "test_helper.h"
+
+TEST_MAIN;
+
+namespace {
+  // pressure of the environment model in Pa
+  BME::Environment rising(uint32_t time_ms) {
+    return BME::Environment {25.0F, 95000.0F + (float)(time_ms % 1000), 40.0F};
+  }
+
+  void testRegisters() {
+    BME::SimulatedBME280 sim;
+    uint8_t chip_id {0};
+    CHECK(sim.read(BME280_REG_CHIP_ID, &chip_id, 1) == BME280_OK);
+    CHECK(chip_id == BME280_CHIP_ID);
+
+    // ctrl_hum becomes effective with the write of ctrl_meas
+    uint8_t regs[] {BME280_OVERSAMPLING_2X, BME280_OVERSAMPLING_1X << 5 | BME280_OVERSAMPLING_1X << 2 | BME280_POWERMODE_FORCED};
+    CHECK(sim.write(BME280_REG_CTRL_HUM, &regs[0], 1) == BME280_OK);
+    CHECK(sim.write(BME280_REG_CTRL_MEAS, &regs[1], 1) == BME280_OK);
+    uint8_t status {0};
+    sim.read(BME280_REG_STATUS, &status, 1);
+    CHECK((status & 0x08) != 0);
+    delayMicroseconds(sim.getConversionTime());
+    sim.read(BME280_REG_STATUS, &status, 1);
+    CHECK((status & 0x08) == 0);
+    // forced mode: back to sleep after the conversion
+    uint8_t ctrl_meas {0};
+    sim.read(BME280_REG_CTRL_MEAS, &ctrl_meas, 1);
+    CHECK((ctrl_meas & 0x03) == BME280_POWERMODE_SLEEP);
+    CHECK(sim.getCounters().conversions == 1);
+  }
+
+  void testForcedMode() {
+    BME::SimulatedBME280 sim;
+    sim.setEnvironment(BME::Environment {21.5F, 98765.0F, 42.0F});
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+
+    // the calibration NVM of the simulator is read by bme280_init()
+    CHECK(bme.getCalibData().dig_t1 == 27504);
+    CHECK(bme.getCalibData().dig_h2 == 362);
+
+    sim.resetCounters();
+    ArduinoShim::reset();
+    CHECK(bme.measure() == BME280_OK);
+    CHECK_NEAR(bme.getTemperature(), 21.5, 0.02);
+    CHECK_NEAR(bme.getPressure(), 987.65, 0.1);
+    CHECK_NEAR(bme.getHumidity(), 42.0, 0.1);
+
+    // one write (trigger) and one burst read per sample, the wait is the predicted measurement time
+    CHECK(sim.getCounters().writes == 1);
+    CHECK(sim.getCounters().reads == 1);
+    CHECK(sim.getCounters().read_bytes == BME280_LEN_P_T_H_DATA);
+    CHECK(sim.getCounters().conversions == 1);
+    CHECK(ArduinoShim::delayTime() == bme.getMeasurementDelay());
+  }
+
+  void testNormalMode() {
+    BME::SimulatedBME280 sim;
+    sim.setEnvironmentModel(rising);
+    BME::Bosch_BME280 bme {sim, 0.0F, false};
+    CHECK(bme.begin() == BME280_OK);
+    delay(1000);
+
+    sim.resetCounters();
+    CHECK(bme.measure() == BME280_OK);
+    CHECK(sim.getCounters().writes == 0);
+    CHECK(sim.getCounters().reads == 1);
+    CHECK_NEAR(bme.getTemperature(), 25.0, 0.02);
+    CHECK_NEAR(bme.getHumidity(), 40.0, 0.1);
+    CHECK(bme.getPressure() >= 949.9F && bme.getPressure() <= 960.1F);
+  }
+
+  void testBeginBurst() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+    // soft reset and one interleaved burst of ctrl_hum, ctrl_meas and config (3 data bytes, 2 addresses)
+    CHECK(sim.getCounters().writes == 2);
+    CHECK(sim.getCounters().write_bytes == 1 + 5);
+  }
+
+  void testSettingsDiff() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, false};
+    CHECK(bme.begin() == BME280_OK);
+    CHECK(bme.setSettings(BME::PRESET_INDOOR_NAVIGATION) == BME280_OK);
+
+    // identical settings: no bus transaction
+    sim.resetCounters();
+    CHECK(bme.setSettings(BME::PRESET_INDOOR_NAVIGATION) == BME280_OK);
+    CHECK(sim.getCounters().reads == 0);
+    CHECK(sim.getCounters().writes == 0);
+
+    // changed settings: one burst write of the changed registers
+    CHECK(bme.setSettings(BME::PRESET_WEATHER_MONITORING) == BME280_OK);
+    CHECK(sim.getCounters().reads == 0);
+    CHECK(sim.getCounters().writes == 1);
+  }
+
+  void testSchedulerLate() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, false};
+    CHECK(bme.begin() == BME280_OK);
+    CHECK(bme.setSettings(BME::PRESET_INDOOR_NAVIGATION) == BME280_OK);
+    CHECK(bme.service() == BME280_OK);
+
+    // the caller is late: 40.5 ms period, service() every 100 ms, every conversion is read or counted as missed
+    sim.resetCounters();
+    for (uint8_t i = 0; i < 100; ++i) {
+      delay(100);
+      CHECK(bme.service() == BME280_OK);
+    }
+    const BME::SchedulerStats &stats = bme.getSchedulerStats();
+    CHECK(stats.samples == 101);
+    CHECK(stats.duplicates == 0);
+    // the reads during a conversion are no drift of the phase
+    CHECK(stats.resyncs == 0);
+    CHECK(stats.samples - 1 + stats.missed == sim.getCounters().conversions);
+  }
+
+  void testSynchronize() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, false};
+    CHECK(bme.begin() == BME280_OK);
+
+    // the conversion found by synchronize() has not been read yet
+    for (uint8_t i = 0; i < 5; ++i) {
+      CHECK(bme.synchronize() == BME280_OK);
+      CHECK(bme.measure() == BME280_OK);
+    }
+    CHECK(bme.getSchedulerStats().samples == 5);
+    CHECK(bme.getSchedulerStats().duplicates == 0);
+    CHECK(bme.synchronize() == BME280_OK);
+    CHECK(bme.service() == BME280_OK);
+    CHECK(bme.getSchedulerStats().samples == 6);
+    CHECK(bme.getSchedulerStats().missed == 0);
+    CHECK(bme.measure() == BME280_OK);
+    CHECK(bme.getSchedulerStats().duplicates == 1);
+  }
+
+  void testSampleBytes() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+    struct {
+      uint8_t channels;
+      uint8_t bytes;
+    } const cases[] {
+      {BME280_ALL, 8},
+      {BME280_TEMP, 3},
+      {BME280_TEMP | BME280_PRESS, 6},
+      {BME280_TEMP | BME280_HUM, 5}
+    };
+    for (const auto &c : cases) {
+      CHECK(bme.setChannels(c.channels) == BME280_OK);
+      sim.resetCounters();
+      CHECK(bme.measure() == BME280_OK);
+      CHECK(bme.getSampleBytes() == c.bytes);
+      CHECK(sim.getCounters().reads == 1);
+      CHECK(sim.getCounters().read_bytes == c.bytes);
+    }
+
+    // service() reads the status register, the reserved bytes and the pressure in the same burst
+    BME::Bosch_BME280 normal {sim, 0.0F, false};
+    CHECK(normal.begin() == BME280_OK);
+    CHECK(normal.service() == BME280_OK);
+    CHECK(normal.getSampleBytes() == 12);
+    CHECK(normal.setChannels(BME280_TEMP | BME280_PRESS) == BME280_OK);
+    CHECK(normal.service() == BME280_OK);
+    CHECK(normal.getSampleBytes() == 10);
+  }
+
+  void testBusFailure() {
+    BME::SimulatedBME280 sim;
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+    sim.setFail(true);
+    CHECK(bme.measure() == BME280_E_COMM_FAIL);
+    CHECK(!bme.isReady());
+    CHECK(bme.getErrorLog().total() == 1);
+    sim.setFail(false);
+    CHECK(bme.measure() == BME280_OK);
+    CHECK(bme.isReady());
+  }
+
+  void testResumeChannels() {
+    BME::SimulatedBME280 sim;
+    sim.setEnvironment(BME::Environment {21.5F, 98765.0F, 42.0F});
+    BME::ResumeState state;
+    {
+      BME::Bosch_BME280 bme {sim, 0.0F, true};
+      CHECK(bme.begin() == BME280_OK);
+      CHECK(bme.setChannels(BME280_TEMP | BME280_HUM) == BME280_OK);
+      bme.saveState(state);
+    }
+
+    // the skipped pressure is restored as a channel, not as the requested oversampling
+    BME::Bosch_BME280 bme {sim, 0.0F, true};
+    CHECK(bme.resume(state) == BME280_OK);
+    CHECK(bme.getChannels() == (BME280_TEMP | BME280_HUM));
+    CHECK(bme.getPressure() == 0.0F);
+    CHECK(bme.setChannels(BME280_ALL) == BME280_OK);
+    CHECK(bme.measure() == BME280_OK);
+    CHECK_NEAR(bme.getPressure(), 987.65, 0.1);
+    CHECK_NEAR(bme.getHumidity(), 42.0, 0.1);
+  }
+}
+
+int main() {
+  testRegisters();
+  testForcedMode();
+  testNormalMode();
+  testBeginBurst();
+  testSettingsDiff();
+  testSchedulerLate();
+  testSynchronize();
+  testSampleBytes();
+  testBusFailure();
+  testResumeChannels();
+  return test::result();
+}
@@ -0,0 +1,97 @@
+/*
+ * Host test of the wrapper on the MockTransport.
+ *
+ * The register map of the mock is loaded with the NVM of the simulated sensor and with raw data.
+ * begin() configures the registers with one burst write, measure() returns the compensation of the
+ * raw data and an injected bus failure is reported.
+ */
+#include <Arduino.h>
+#include <Bosch_BME280_Arduino.h>
+#include <Bosch_BME280_Simulator.h>
+#include "test_helper.h"
+
+TEST_MAIN;
+
+namespace {
+  // chip id, calibration NVM and reset state of the simulated sensor
+  void loadRegisters(BME::MockTransport &mock) {
+    BME::SimulatedBME280 sim;
+    uint8_t registers[256 - BME280_REG_TEMP_PRESS_CALIB_DATA];
+    CHECK(sim.read(BME280_REG_TEMP_PRESS_CALIB_DATA, registers, sizeof(registers)) == BME280_OK);
+    for (uint16_t i = 0; i < sizeof(registers); ++i) {
+      mock.reg((uint8_t)(BME280_REG_TEMP_PRESS_CALIB_DATA + i)) = registers[i];
+    }
+  }
+
+  // data registers 0xF7...0xFE of a raw sample
+  void setRawData(BME::MockTransport &mock, const struct bme280_uncomp_data &raw) {
+    mock.reg(0xF7) = (uint8_t)(raw.pressure >> 12);
+    mock.reg(0xF8) = (uint8_t)(raw.pressure >> 4);
+    mock.reg(0xF9) = (uint8_t)(raw.pressure << 4);
+    mock.reg(0xFA) = (uint8_t)(raw.temperature >> 12);
+    mock.reg(0xFB) = (uint8_t)(raw.temperature >> 4);
+    mock.reg(0xFC) = (uint8_t)(raw.temperature << 4);
+    mock.reg(0xFD) = (uint8_t)(raw.humidity >> 8);
+    mock.reg(0xFE) = (uint8_t)raw.humidity;
+  }
+
+  void testBegin() {
+    BME::MockTransport mock;
+    loadRegisters(mock);
+    BME::Bosch_BME280 bme {mock, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+    // soft reset and one burst of ctrl_hum, ctrl_meas and config, decoded like the sensor does
+    CHECK(mock.getWrites() == 2);
+    CHECK(mock.reg(BME280_REG_CTRL_HUM) == BME::OSR_1X);
+    CHECK(mock.reg(BME280_REG_CTRL_MEAS) == ((BME::OSR_1X << 5) | (BME::OSR_1X << 2)));
+    CHECK(mock.reg(BME280_REG_CONFIG) == (BME::STANDBY_1000_MS << 5));
+  }
+
+  void testMeasure() {
+    BME::MockTransport mock;
+    loadRegisters(mock);
+    BME::Bosch_BME280 bme {mock, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+    const struct bme280_uncomp_data raw {415148, 519888, 30000};
+    setRawData(mock, raw);
+
+    uint32_t reads = mock.getReads();
+    uint32_t writes = mock.getWrites();
+    CHECK(bme.measure() == BME280_OK);
+    // one trigger of the forced mode and one burst read of the data registers
+    CHECK(mock.getWrites() == writes + 1);
+    CHECK(mock.getReads() == reads + 1);
+    CHECK((mock.reg(BME280_REG_CTRL_MEAS) & 0x03) == BME280_POWERMODE_FORCED);
+
+    struct bme280_data data;
+    CHECK(BME::compensateSamples(&raw, &data, 1, bme.getCalibData()) == BME280_OK);
+    CHECK(bme.getRawData().pressure == raw.pressure);
+    CHECK(bme.getRawData().temperature == raw.temperature);
+    CHECK(bme.getRawData().humidity == raw.humidity);
+#ifdef BME280_DOUBLE_ENABLE
+    CHECK(bme.getTemperature() == (float) data.temperature);
+#else
+    CHECK(bme.getTemperatureInt() == data.temperature);
+#endif
+  }
+
+  void testFailure() {
+    BME::MockTransport mock;
+    loadRegisters(mock);
+    BME::Bosch_BME280 bme {mock, 0.0F, true};
+    CHECK(bme.begin() == BME280_OK);
+    mock.setFail(true);
+    CHECK(bme.measure() == BME280_E_COMM_FAIL);
+    CHECK(!bme.isReady());
+    mock.setFail(false);
+    CHECK(bme.measure() == BME280_OK);
+    CHECK(bme.isReady());
+  }
+}
+
+int main() {
+  testBegin();
+  testMeasure();
+  testFailure();
+  return test::result();
+}